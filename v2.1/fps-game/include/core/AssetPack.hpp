@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fps::core {
+
+// Pack layout, shared with the AssetPacker tool (native byte order):
+//   header   "FPAK" u16 version, u16 flags, u32 entry count, u32 blob
+//            alignment, u64 names offset, u64 names size
+//   index    entry count x AssetPackEntry, sorted by name hash
+//   names    concatenated entry names, not terminated
+//   blobs    one per entry, each starting on the blob alignment
+struct AssetPackHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct AssetPackEntry {
+    uint64_t hash;       // FNV-1a of the name
+    uint64_t offset;     // of the blob, from the start of the pack
+    uint64_t size;       // unpacked bytes
+    uint64_t storedSize; // bytes in the pack; equals size when stored raw
+    uint32_t nameOffset; // into the names block
+    uint16_t nameLength;
+    uint8_t compression; // 0 raw, 1 LZ
+    uint8_t reserved;
+};
+
+// Read-only, memory-mapped view of the game's asset pack. Entries are
+// named by their path relative to the directory that was packed, so a pack
+// built from the game's working directory answers to the same paths the
+// loaders already use.
+class AssetPack {
+public:
+    static AssetPack& GetInstance();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Points into the mapping until Close(); nullptr for missing and
+    // compressed entries
+    const uint8_t* Find(const std::string& name, size_t& size) const;
+    // Copies (or unpacks) the entry into 'out'
+    bool Read(const std::string& name, std::vector<uint8_t>& out) const;
+
+    size_t GetEntryCount() const { return m_entryCount; }
+
+private:
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    const AssetPackEntry* FindEntry(const std::string& name) const;
+
+    const uint8_t* m_data;
+    size_t m_size;
+    const AssetPackEntry* m_entries;
+    size_t m_entryCount;
+    const char* m_names;
+#ifdef PLATFORM_WINDOWS
+    void* m_mapping; // file mapping HANDLE
+#endif
+};
+
+// Bytes of one asset: a view into the pack when it is stored raw there,
+// otherwise an owned copy
+class AssetData {
+public:
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    friend bool LoadAsset(const std::string& path, AssetData& asset);
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<uint8_t> m_storage;
+};
+
+// Looks 'path' up in the open pack first and falls back to the loose file
+bool LoadAsset(const std::string& path, AssetData& asset);
+
+} // namespace fps::core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <glad/glad.h>
@@ -21,7 +22,20 @@ public:
     Shader& operator=(Shader&& other) noexcept;
     
     bool LoadFromFile(const std::string& vertexPath, const std::string& fragmentPath);
+    // Compiles and links, waiting for the driver; same as BeginCompile()
+    // followed by FinishCompile()
     bool LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+    // Restores the program from the binary cache, or hands both stages
+    // and the link to the driver without waiting for or checking them, so
+    // several programs can compile at once
+    bool BeginCompile(const std::string& vertexSource, const std::string& fragmentSource);
+    // True once FinishCompile() won't block. Only drivers with
+    // GL_KHR_parallel_shader_compile can tell; others always say true.
+    bool IsReady() const;
+    // Waits for the pending compile and logs its errors; on failure the
+    // shader is left without a program
+    bool FinishCompile();
+    bool IsPending() const { return m_vertexShader != 0; }
     bool LoadCompute(const std::string& computePath);
     bool LoadComputeSource(const std::string& computeSource);
     
@@ -46,15 +60,32 @@ public:
     
     static void UnbindAll();
     
+    // Keeps linked programs in 'directory' (glGetProgramBinary) so later
+    // launches skip compiling. Entries are keyed by the sources and the
+    // driver's vendor/renderer/version; any the driver refuses are
+    // recompiled and replaced. Needs a current context; empty turns it off.
+    static void SetBinaryCacheDirectory(const std::string& directory);
+    
 private:
     GLuint m_programID;
     mutable std::unordered_map<std::string, GLint> m_uniformCache;
     
+    // Stages of a compile started by BeginCompile(), until FinishCompile()
+    GLuint m_vertexShader;
+    GLuint m_fragmentShader;
+    std::string m_cachePath; // where FinishCompile() saves the binary
+    uint64_t m_cacheKey;
+    
     bool CompileShader(GLuint shader, const std::string& source, const std::string& type);
-    bool LinkProgram(GLuint vertexShader, GLuint fragmentShader);
     bool LinkComputeProgram(GLuint computeShader);
     std::string ReadFile(const std::string& filepath);
     GLint GetUniformLocation(const std::string& name) const;
+    
+    bool LoadBinary(const std::string& path, uint64_t key);
+    void SaveBinary(const std::string& path, uint64_t key) const;
+    
+    static std::string s_binaryCacheDirectory; // empty when the cache is off
+    static std::string s_driver;
 };
 
 } // namespace fps::renderer
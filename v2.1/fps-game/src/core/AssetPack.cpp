@@ -0,0 +1,286 @@
+#include "core/AssetPack.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fps::core {
+
+static const char kMagic[4] = {'F', 'P', 'A', 'K'};
+static const uint16_t kVersion = 1;
+static const uint8_t kCompressionNone = 0;
+static const uint8_t kCompressionLZ = 1;
+
+static_assert(sizeof(AssetPackHeader) == 32, "pack header layout changed");
+static_assert(sizeof(AssetPackEntry) == 40, "pack entry layout changed");
+
+namespace {
+
+uint64_t HashName(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ReadLength(const uint8_t*& src, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (src >= end) return false;
+        byte = *src++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Token: high nibble literal count, low nibble match length - 4; 15 in
+// either means more length bytes follow. The last sequence has no match.
+bool Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    const uint8_t* end = src + size;
+    size_t written = 0;
+
+    while (src < end) {
+        uint8_t token = *src++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLength(src, end, literalCount)) return false;
+        if (literalCount > static_cast<size_t>(end - src) || literalCount > dstSize - written) return false;
+        std::memcpy(dst + written, src, literalCount);
+        src += literalCount;
+        written += literalCount;
+        if (src == end) break;
+
+        if (end - src < 2) return false;
+        size_t offset = src[0] | (static_cast<size_t>(src[1]) << 8);
+        src += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !ReadLength(src, end, matchLength)) return false;
+        matchLength += 4;
+        if (offset == 0 || offset > written || matchLength > dstSize - written) return false;
+
+        // Byte by byte: a match may overlap the bytes it is producing
+        const uint8_t* from = dst + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            dst[written + i] = from[i];
+        }
+        written += matchLength;
+    }
+    return written == dstSize;
+}
+
+} // namespace
+
+AssetPack& AssetPack::GetInstance() {
+    static AssetPack instance;
+    return instance;
+}
+
+AssetPack::AssetPack()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_entries(nullptr)
+    , m_entryCount(0)
+    , m_names(nullptr)
+#ifdef PLATFORM_WINDOWS
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+bool AssetPack::Open(const std::string& path) {
+    Close();
+
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Failed to open asset pack: " + path);
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(AssetPackHeader))) {
+        LOG_ERROR("Asset pack is truncated: " + path);
+        CloseHandle(file);
+        return false;
+    }
+    // The mapping keeps the file open
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    void* data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        LOG_ERROR("Failed to map asset pack: " + path);
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        LOG_ERROR("Failed to open asset pack: " + path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(AssetPackHeader))) {
+        LOG_ERROR("Asset pack is truncated: " + path);
+        ::close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map asset pack: " + path);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    madvise(data, m_size, MADV_WILLNEED);
+#endif
+    m_data = static_cast<const uint8_t*>(data);
+
+    AssetPackHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        LOG_ERROR("Asset pack has an unknown format: " + path);
+        Close();
+        return false;
+    }
+
+    uint64_t indexEnd = sizeof(AssetPackHeader) + uint64_t(header.entryCount) * sizeof(AssetPackEntry);
+    bool valid = indexEnd <= m_size && header.namesOffset >= indexEnd &&
+                 header.namesOffset <= m_size && header.namesSize <= m_size - header.namesOffset;
+    m_entries = reinterpret_cast<const AssetPackEntry*>(m_data + sizeof(AssetPackHeader));
+    m_entryCount = header.entryCount;
+    m_names = reinterpret_cast<const char*>(m_data + header.namesOffset);
+
+    // Checked once here so lookups can trust the index
+    for (size_t i = 0; valid && i < m_entryCount; ++i) {
+        const AssetPackEntry& entry = m_entries[i];
+        valid = entry.offset <= m_size && entry.storedSize <= m_size - entry.offset &&
+                uint64_t(entry.nameOffset) + entry.nameLength <= header.namesSize &&
+                (i == 0 || m_entries[i - 1].hash <= entry.hash);
+        if (entry.compression == kCompressionNone) {
+            valid = valid && entry.storedSize == entry.size;
+        } else if (entry.compression != kCompressionLZ) {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        LOG_ERROR("Asset pack is corrupt: " + path);
+        Close();
+        return false;
+    }
+
+    LOG_INFO("Asset pack opened: " + path + " (" + std::to_string(m_entryCount) + " entries)");
+    return true;
+}
+
+void AssetPack::Close() {
+#ifdef PLATFORM_WINDOWS
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+}
+
+const AssetPackEntry* AssetPack::FindEntry(const std::string& name) const {
+    uint64_t hash = HashName(name);
+    const AssetPackEntry* end = m_entries + m_entryCount;
+    const AssetPackEntry* entry = std::lower_bound(m_entries, end, hash,
+        [](const AssetPackEntry& e, uint64_t h) { return e.hash < h; });
+
+    for (; entry != end && entry->hash == hash; ++entry) {
+        if (entry->nameLength == name.size() &&
+            std::memcmp(m_names + entry->nameOffset, name.data(), name.size()) == 0) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* AssetPack::Find(const std::string& name, size_t& size) const {
+    const AssetPackEntry* entry = FindEntry(name);
+    if (!entry || entry->compression != kCompressionNone) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(entry->size);
+    return m_data + entry->offset;
+}
+
+bool AssetPack::Read(const std::string& name, std::vector<uint8_t>& out) const {
+    const AssetPackEntry* entry = FindEntry(name);
+    if (!entry) {
+        return false;
+    }
+
+    const uint8_t* stored = m_data + entry->offset;
+    if (entry->compression == kCompressionNone) {
+        out.assign(stored, stored + entry->size);
+        return true;
+    }
+
+    out.resize(static_cast<size_t>(entry->size));
+    if (!Decompress(stored, static_cast<size_t>(entry->storedSize), out.data(), out.size())) {
+        LOG_ERROR("Asset failed to decompress: " + name);
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool LoadAsset(const std::string& path, AssetData& asset) {
+    const AssetPack& pack = AssetPack::GetInstance();
+    asset.m_storage.clear();
+
+    if (pack.IsOpen()) {
+        asset.m_data = pack.Find(path, asset.m_size);
+        if (asset.m_data) {
+            return true;
+        }
+        if (pack.Read(path, asset.m_storage)) {
+            asset.m_data = asset.m_storage.data();
+            asset.m_size = asset.m_storage.size();
+            return true;
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        asset.m_data = nullptr;
+        asset.m_size = 0;
+        return false;
+    }
+    asset.m_storage.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(asset.m_storage.data()), static_cast<std::streamsize>(asset.m_storage.size()));
+    asset.m_data = asset.m_storage.data();
+    asset.m_size = asset.m_storage.size();
+    return static_cast<bool>(file);
+}
+
+} // namespace fps::core
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <memory>
 #include <cmath>
+#include <filesystem>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -11,6 +12,7 @@
 #include "core/Input.hpp"
 #include "core/Timer.hpp"
 #include "core/Logger.hpp"
+#include "core/AssetPack.hpp"
 
 #include "renderer/Shader.hpp"
 #include "renderer/Mesh.hpp"
@@ -159,6 +161,11 @@ public:
             return false;
         }
         
+        // Assets come from the pack when there is one, loose files otherwise
+        if (std::filesystem::exists("assets.pak")) {
+            core::AssetPack::GetInstance().Open("assets.pak");
+        }
+        
         // Initialize input
         core::Input::GetInstance().Initialize(window->GetNativeWindow());
         core::Input::GetInstance().SetMouseVisible(false);
@@ -170,6 +177,9 @@ public:
             return false;
         }
         
+        // Reuse linked programs from earlier launches
+        renderer::Shader::SetBinaryCacheDirectory("shader_cache");
+        
         // Create player
         player = std::make_unique<Player>();
         player->camera.SetPosition(glm::vec3(0.0f, 2.0f, 5.0f));
@@ -235,7 +245,8 @@ public:
             }
         )";
         
-        worldShader->LoadFromSource(worldVert, worldFrag);
+        // Both programs compile at once; they are waited on after the meshes
+        worldShader->BeginCompile(worldVert, worldFrag);
         
         // Enemy shader (simpler, for performance)
         enemyShader = std::make_unique<renderer::Shader>();
@@ -280,7 +291,7 @@ public:
             }
         )";
         
-        enemyShader->LoadFromSource(enemyVert, enemyFrag);
+        enemyShader->BeginCompile(enemyVert, enemyFrag);
         
         // Create meshes
         cubeMesh = std::make_unique<renderer::Mesh>();
@@ -296,6 +307,9 @@ public:
         std::vector<unsigned int> floorIndices = {0, 1, 2, 0, 2, 3};
         floorMesh->Create(floorVerts, floorIndices);
         
+        worldShader->FinishCompile();
+        enemyShader->FinishCompile();
+        
         // Spawn initial enemies
         SpawnEnemies(5);
         
@@ -476,6 +490,7 @@ public:
     
     void Shutdown() {
         renderer::Renderer::GetInstance().Shutdown();
+        core::AssetPack::GetInstance().Close();
         window->Shutdown();
         LOG_INFO("Game shutdown");
     }
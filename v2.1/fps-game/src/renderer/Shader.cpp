@@ -1,20 +1,109 @@
 #include "renderer/Shader.hpp"
 #include "core/Logger.hpp"
+#include "core/AssetPack.hpp"
+#include <GLFW/glfw3.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
 #include <iostream>
+#include <vector>
 
 namespace fps::renderer {
 
-Shader::Shader() : m_programID(0) {
+// Program binary file: "FPSB" u16 version, u64 key, u32 format, u32
+// length, then the driver's binary. Native-endian; the files never leave
+// the machine that wrote them.
+static const char kBinaryMagic[4] = {'F', 'P', 'S', 'B'};
+static const uint16_t kBinaryVersion = 1;
+
+std::string Shader::s_binaryCacheDirectory;
+std::string Shader::s_driver;
+
+namespace {
+
+// FNV-1a, with a separator so "ab" + "c" and "a" + "bc" differ
+void HashString(uint64_t& hash, const std::string& text) {
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    hash = (hash ^ 0xFF) * 1099511628211ull;
+}
+
+std::string GLString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+// GL_KHR_parallel_shader_compile (or its ARB twin) lets the driver
+// compile on its own threads and answer COMPLETION_STATUS without
+// blocking. Checked once, on the first compile.
+bool ParallelCompileAvailable() {
+    static const bool available = []() {
+        bool supported = glfwExtensionSupported("GL_KHR_parallel_shader_compile") ||
+                         glfwExtensionSupported("GL_ARB_parallel_shader_compile");
+        if (!supported || !glMaxShaderCompilerThreadsKHR) {
+            return false;
+        }
+        // Let the driver pick the thread count
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        return true;
+    }();
+    return available;
+}
+
+GLuint SubmitShader(GLenum type, const std::string& source) {
+    GLuint shader = glCreateShader(type);
+    const char* src = source.c_str();
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+bool CheckShader(GLuint shader, const std::string& type) {
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        LOG_ERROR("Shader compilation failed (" + type + "): " + std::string(infoLog));
+        return false;
+    }
+    
+    return true;
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return static_cast<size_t>(in.gcount()) == sizeof(value);
+}
+
+template <typename T>
+void WriteValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+Shader::Shader() : m_programID(0), m_vertexShader(0), m_fragmentShader(0), m_cacheKey(0) {
 }
 
 Shader::~Shader() {
     Delete();
 }
 
-Shader::Shader(Shader&& other) noexcept : m_programID(other.m_programID), m_uniformCache(std::move(other.m_uniformCache)) {
+Shader::Shader(Shader&& other) noexcept
+    : m_programID(other.m_programID)
+    , m_uniformCache(std::move(other.m_uniformCache))
+    , m_vertexShader(other.m_vertexShader)
+    , m_fragmentShader(other.m_fragmentShader)
+    , m_cachePath(std::move(other.m_cachePath))
+    , m_cacheKey(other.m_cacheKey) {
     other.m_programID = 0;
+    other.m_vertexShader = 0;
+    other.m_fragmentShader = 0;
 }
 
 Shader& Shader::operator=(Shader&& other) noexcept {
@@ -22,12 +111,24 @@ Shader& Shader::operator=(Shader&& other) noexcept {
         Delete();
         m_programID = other.m_programID;
         m_uniformCache = std::move(other.m_uniformCache);
+        m_vertexShader = other.m_vertexShader;
+        m_fragmentShader = other.m_fragmentShader;
+        m_cachePath = std::move(other.m_cachePath);
+        m_cacheKey = other.m_cacheKey;
         other.m_programID = 0;
+        other.m_vertexShader = 0;
+        other.m_fragmentShader = 0;
     }
     return *this;
 }
 
 void Shader::Delete() {
+    if (m_vertexShader != 0) {
+        glDeleteShader(m_vertexShader);
+        glDeleteShader(m_fragmentShader);
+        m_vertexShader = 0;
+        m_fragmentShader = 0;
+    }
     if (m_programID != 0) {
         glDeleteProgram(m_programID);
         m_programID = 0;
@@ -36,54 +137,20 @@ void Shader::Delete() {
 }
 
 std::string Shader::ReadFile(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    core::AssetData asset;
+    if (!core::LoadAsset(filepath, asset)) {
         LOG_ERROR("Failed to open shader file: " + filepath);
         return "";
     }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    return std::string(reinterpret_cast<const char*>(asset.GetData()), asset.GetSize());
 }
 
 bool Shader::CompileShader(GLuint shader, const std::string& source, const std::string& type) {
     const char* src = source.c_str();
     glShaderSource(shader, 1, &src, nullptr);
     glCompileShader(shader);
-    
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        LOG_ERROR("Shader compilation failed (" + type + "): " + std::string(infoLog));
-        return false;
-    }
-    
-    return true;
-}
-
-bool Shader::LinkProgram(GLuint vertexShader, GLuint fragmentShader) {
-    m_programID = glCreateProgram();
-    glAttachShader(m_programID, vertexShader);
-    glAttachShader(m_programID, fragmentShader);
-    glLinkProgram(m_programID);
-    
-    GLint success;
-    glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
-    
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(m_programID, 512, nullptr, infoLog);
-        LOG_ERROR("Shader program linking failed: " + std::string(infoLog));
-        glDeleteProgram(m_programID);
-        m_programID = 0;
-        return false;
-    }
-    
-    return true;
+    return CheckShader(shader, type);
 }
 
 bool Shader::LinkComputeProgram(GLuint computeShader) {
@@ -118,24 +185,88 @@ bool Shader::LoadFromFile(const std::string& vertexPath, const std::string& frag
 }
 
 bool Shader::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    return BeginCompile(vertexSource, fragmentSource) && FinishCompile();
+}
+
+bool Shader::BeginCompile(const std::string& vertexSource, const std::string& fragmentSource) {
+    Delete();
+    m_cachePath.clear();
     
-    if (!CompileShader(vertexShader, vertexSource, "vertex") ||
-        !CompileShader(fragmentShader, fragmentSource, "fragment")) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
+    if (!s_binaryCacheDirectory.empty()) {
+        m_cacheKey = 14695981039346656037ull;
+        HashString(m_cacheKey, s_driver);
+        HashString(m_cacheKey, vertexSource);
+        HashString(m_cacheKey, fragmentSource);
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(m_cacheKey));
+        std::string path = (std::filesystem::path(s_binaryCacheDirectory) / name).string();
+        
+        if (LoadBinary(path, m_cacheKey)) {
+            LOG_DEBUG("Shader program loaded from cache (ID: " + std::to_string(m_programID) + ")");
+            return true;
+        }
+        m_cachePath = path;
+    }
+    
+    ParallelCompileAvailable();
+    m_vertexShader = SubmitShader(GL_VERTEX_SHADER, vertexSource);
+    m_fragmentShader = SubmitShader(GL_FRAGMENT_SHADER, fragmentSource);
+    
+    m_programID = glCreateProgram();
+    glAttachShader(m_programID, m_vertexShader);
+    glAttachShader(m_programID, m_fragmentShader);
+    if (!m_cachePath.empty()) {
+        glProgramParameteri(m_programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    // Linking a program whose shaders failed just fails too; the compile
+    // logs are read in FinishCompile()
+    glLinkProgram(m_programID);
+    return m_programID != 0;
+}
+
+bool Shader::IsReady() const {
+    // Without the extension any status query blocks, so report ready and
+    // let FinishCompile() take the wait
+    if (!IsPending() || !ParallelCompileAvailable()) {
+        return true;
     }
     
-    if (!LinkProgram(vertexShader, fragmentShader)) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+    GLint done = GL_FALSE;
+    glGetProgramiv(m_programID, GL_COMPLETION_STATUS_KHR, &done);
+    return done != GL_FALSE;
+}
+
+bool Shader::FinishCompile() {
+    if (!IsPending()) {
+        return m_programID != 0;
+    }
+    
+    bool success = CheckShader(m_vertexShader, "vertex") && CheckShader(m_fragmentShader, "fragment");
+    if (success) {
+        GLint linked;
+        glGetProgramiv(m_programID, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            char infoLog[512];
+            glGetProgramInfoLog(m_programID, 512, nullptr, infoLog);
+            LOG_ERROR("Shader program linking failed: " + std::string(infoLog));
+            success = false;
+        }
+    }
+    
+    // The program keeps what it needs once linked
+    glDeleteShader(m_vertexShader);
+    glDeleteShader(m_fragmentShader);
+    m_vertexShader = 0;
+    m_fragmentShader = 0;
+    
+    if (!success) {
+        Delete();
         return false;
     }
     
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    if (!m_cachePath.empty()) {
+        SaveBinary(m_cachePath, m_cacheKey);
+    }
     
     LOG_DEBUG("Shader program created successfully (ID: " + std::to_string(m_programID) + ")");
     return true;
@@ -168,6 +299,118 @@ bool Shader::LoadComputeSource(const std::string& computeSource) {
     return true;
 }
 
+void Shader::SetBinaryCacheDirectory(const std::string& directory) {
+    s_binaryCacheDirectory.clear();
+    if (directory.empty() || !glGetProgramBinary || !glProgramBinary || !glProgramParameteri) {
+        return;
+    }
+    
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        LOG_WARNING("Shader cache disabled: driver exposes no program binary formats");
+        return;
+    }
+    
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        LOG_ERROR("Shader cache disabled: cannot create " + directory + ": " + error.message());
+        return;
+    }
+    
+    s_driver = GLString(GL_VENDOR) + "|" + GLString(GL_RENDERER) + "|" + GLString(GL_VERSION);
+    s_binaryCacheDirectory = directory;
+}
+
+bool Shader::LoadBinary(const std::string& path, uint64_t key) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+    
+    char magic[4];
+    uint16_t version;
+    uint64_t storedKey;
+    uint32_t format, length;
+    in.read(magic, sizeof(magic));
+    bool valid = in.gcount() == sizeof(magic) && std::memcmp(magic, kBinaryMagic, sizeof(magic)) == 0 &&
+                 ReadValue(in, version) && version == kBinaryVersion &&
+                 ReadValue(in, storedKey) && storedKey == key &&
+                 ReadValue(in, format) && ReadValue(in, length);
+    
+    // Check the length against what is really there before allocating for it
+    std::vector<char> binary;
+    if (valid) {
+        valid = length > 0 && static_cast<std::streamoff>(length) == fileSize - in.tellg();
+    }
+    if (valid) {
+        binary.resize(length);
+        in.read(binary.data(), length);
+        valid = static_cast<size_t>(in.gcount()) == length;
+    }
+    if (!valid) {
+        LOG_WARNING("Shader cache entry is corrupt, recompiling: " + path);
+        return false;
+    }
+    
+    m_programID = glCreateProgram();
+    glProgramBinary(m_programID, static_cast<GLenum>(format), binary.data(), static_cast<GLsizei>(length));
+    
+    GLint success;
+    glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
+    if (!success) {
+        // Usually a driver update that kept its version string
+        LOG_WARNING("Driver refused cached shader program, recompiling: " + path);
+        glDeleteProgram(m_programID);
+        m_programID = 0;
+        return false;
+    }
+    return true;
+}
+
+void Shader::SaveBinary(const std::string& path, uint64_t key) const {
+    GLint length = 0;
+    glGetProgramiv(m_programID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(m_programID, length, &length, &format, binary.data());
+    if (length <= 0) {
+        return;
+    }
+    
+    // Written aside and renamed, so a crash never leaves a torn file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return;
+        }
+        out.write(kBinaryMagic, sizeof(kBinaryMagic));
+        WriteValue(out, kBinaryVersion);
+        WriteValue(out, key);
+        WriteValue(out, static_cast<uint32_t>(format));
+        WriteValue(out, static_cast<uint32_t>(length));
+        out.write(binary.data(), length);
+        if (!out) {
+            return;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) {
+        LOG_ERROR("Shader cache: cannot write " + path + ": " + error.message());
+        std::filesystem::remove(temp, error);
+    }
+}
+
 void Shader::Bind() const {
     glUseProgram(m_programID);
 }
@@ -1,6 +1,8 @@
 #include "renderer/Texture.hpp"
 #include "core/Logger.hpp"
+#include "core/AssetPack.hpp"
 #include <stb_image.h>
+#include <climits>
 
 namespace fps::renderer {
 
@@ -77,10 +79,23 @@ GLenum Texture2D::GetDataType(TextureFormat format) {
     }
 }
 
+namespace {
+
+// Decodes an image from the asset pack, or from disk when it isn't packed
+unsigned char* LoadImage(const std::string& filepath, int* width, int* height, int* channels) {
+    core::AssetData asset;
+    if (!core::LoadAsset(filepath, asset) || asset.GetSize() > static_cast<size_t>(INT_MAX)) {
+        return nullptr;
+    }
+    return stbi_load_from_memory(asset.GetData(), static_cast<int>(asset.GetSize()), width, height, channels, 0);
+}
+
+} // namespace
+
 bool Texture2D::LoadFromFile(const std::string& filepath, const TextureConfig& config) {
     stbi_set_flip_vertically_on_load(true);
     
-    unsigned char* data = stbi_load(filepath.c_str(), &m_width, &m_height, &m_channels, 0);
+    unsigned char* data = LoadImage(filepath, &m_width, &m_height, &m_channels);
     
     if (!data) {
         LOG_ERROR("Failed to load texture: " + filepath);
@@ -240,7 +255,7 @@ bool Cubemap::LoadFromFiles(const std::string& right, const std::string& left,
     stbi_set_flip_vertically_on_load(false);
     
     for (unsigned int i = 0; i < 6; i++) {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &channels, 0);
+        unsigned char* data = LoadImage(faces[i], &width, &height, &channels);
         
         if (data) {
             GLenum format = GetDataFormat(channels);
@@ -397,3 +397,11 @@ GLAD_FUNCTION_POINTER(PFNGLCOLORP4UIPROC, glColorP4ui)
 GLAD_FUNCTION_POINTER(PFNGLCOLORP4UIVPROC, glColorP4uiv)
 GLAD_FUNCTION_POINTER(PFNGLSECONDARYCOLORP3UIPROC, glSecondaryColorP3ui)
 GLAD_FUNCTION_POINTER(PFNGLSECONDARYCOLORP3UIVPROC, glSecondaryColorP3uiv)
+
+// ARB_get_program_binary (core in GL 4.1; NULL when the driver lacks it)
+GLAD_FUNCTION_POINTER(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary)
+GLAD_FUNCTION_POINTER(PFNGLPROGRAMBINARYPROC, glProgramBinary)
+GLAD_FUNCTION_POINTER(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri)
+
+// KHR_parallel_shader_compile (NULL when the driver lacks it)
+GLAD_FUNCTION_POINTER(PFNGLMAXSHADERCOMPILERTHREADSKHRPROC, glMaxShaderCompilerThreadsKHR)
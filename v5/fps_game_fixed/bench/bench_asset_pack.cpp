@@ -0,0 +1,150 @@
+#include "engine/AssetPack.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Writes a directory of small loose files, packs them, then compares
+// reading every file with ifstream against opening the pack and touching
+// every entry through the mapping. Each entry is checked against the
+// original bytes (raw and compressed packs); a mismatch exits non-zero.
+//
+// Both timings are warm-cache, so they measure per-file syscall and copy
+// overhead rather than the disk.
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Mostly repetitive bytes with some noise, so --compress has work to do
+std::vector<uint8_t> makeAsset(std::mt19937& rng, size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = rng() % 8 == 0 ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>(i / 16);
+    }
+    return data;
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t files = 2000;
+    size_t fileSize = 16 * 1024;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            fileSize = std::strtoul(argv[++i], nullptr, 10);
+        }
+    }
+
+    fs::path root = fs::temp_directory_path() / "fpsgame_bench_assets";
+    fs::remove_all(root);
+    fs::create_directories(root / "loose");
+
+    std::mt19937 rng(5);
+    std::vector<std::string> names;
+    std::vector<std::vector<uint8_t>> assets;
+    Engine::AssetPackWriter raw, packed;
+    for (size_t i = 0; i < files; ++i) {
+        names.push_back("textures/asset" + std::to_string(i) + ".bin");
+        assets.push_back(makeAsset(rng, fileSize / 2 + rng() % fileSize));
+        fs::create_directories((root / "loose" / names.back()).parent_path());
+        std::ofstream out(root / "loose" / names.back(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(assets.back().data()), assets.back().size());
+        raw.add(names.back(), assets.back());
+        packed.add(names.back(), assets.back(), true);
+    }
+    std::string rawPath = (root / "raw.pak").string();
+    std::string packedPath = (root / "packed.pak").string();
+    if (!raw.write(rawPath) || !packed.write(packedPath)) return 1;
+
+    size_t wrong = 0;
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> buffer;
+    for (const std::string& name : names) {
+        std::ifstream in(root / "loose" / name, std::ios::binary | std::ios::ate);
+        buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        checksum += buffer[buffer.size() / 2];
+    }
+    double looseMs = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        Engine::AssetPack pack;
+        if (!pack.open(rawPath)) return 1;
+        for (const std::string& name : names) {
+            size_t size = 0;
+            const uint8_t* data = pack.find(name, size);
+            if (!data) { ++wrong; continue; }
+            checksum += data[size / 2];
+        }
+    }
+    double rawMs = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        Engine::AssetPack pack;
+        if (!pack.open(packedPath)) return 1;
+        for (const std::string& name : names) {
+            if (!pack.read(name, buffer)) { ++wrong; continue; }
+            checksum += buffer[buffer.size() / 2];
+        }
+    }
+    double packedMs = msSince(start);
+
+    // Untimed: every entry must come back byte for byte
+    for (const std::string& path : { rawPath, packedPath }) {
+        Engine::AssetPack pack;
+        if (!pack.open(path)) return 1;
+        for (size_t i = 0; i < files; ++i) {
+            if (!pack.read(names[i], buffer) || buffer != assets[i]) ++wrong;
+        }
+        if (pack.contains("textures/missing.bin")) ++wrong;
+    }
+
+    // A names offset past the end of the file has to be rejected, not
+    // wrapped into a huge names size
+    {
+        std::string corruptPath = (root / "corrupt.pak").string();
+        Engine::AssetPackWriter writer;
+        writer.add(names[0], assets[0]);
+        if (!writer.write(corruptPath)) return 1;
+        uint64_t namesOffset = fs::file_size(corruptPath) + 4096;
+        std::fstream file(corruptPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offsetof(Engine::AssetPackHeader, namesOffset));
+        file.write(reinterpret_cast<const char*>(&namesOffset), sizeof(namesOffset));
+        file.close();
+
+        Engine::AssetPack pack;
+        if (pack.open(corruptPath)) ++wrong;
+    }
+
+    uint64_t inputBytes = 0;
+    for (const std::vector<uint8_t>& asset : assets) inputBytes += asset.size();
+
+    std::cout << files << " files, " << inputBytes / 1024 << " KB (checksum " << checksum << ")" << std::endl;
+    std::cout << "  loose files:     " << looseMs << " ms" << std::endl;
+    std::cout << "  raw pack:        " << rawMs << " ms (" << fs::file_size(rawPath) / 1024
+              << " KB, zero-copy)" << std::endl;
+    std::cout << "  compressed pack: " << packedMs << " ms (" << fs::file_size(packedPath) / 1024
+              << " KB)" << std::endl;
+    std::cout << "  " << wrong << " entries wrong" << std::endl;
+
+    fs::remove_all(root);
+    return wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include "engine/BVH.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Times BVH ray, sphere and box queries against a brute-force loop over
+// the same boxes, and checks both agree. Scene is a field of random
+// wall-sized boxes, roughly what a large level would feed Level::generate.
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double nsPer(size_t count) const {
+        return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / count;
+    }
+};
+
+bool overlapsSphere(const Engine::AABB& box, const glm::vec3& c, float r) {
+    glm::vec3 p(std::max(box.min.x, std::min(c.x, box.max.x)),
+                std::max(box.min.y, std::min(c.y, box.max.y)),
+                std::max(box.min.z, std::min(c.z, box.max.z)));
+    glm::vec3 d = p - c;
+    return glm::dot(d, d) <= r * r;
+}
+
+bool overlapsBox(const Engine::AABB& a, const glm::vec3& min, const glm::vec3& max) {
+    return a.min.x <= max.x && a.max.x >= min.x &&
+           a.min.y <= max.y && a.max.y >= min.y &&
+           a.min.z <= max.z && a.max.z >= min.z;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t boxCount = 10000;
+    size_t queries = 100000;
+    float worldSize = 500.0f;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--boxes") == 0 && i + 1 < argc) {
+            boxCount = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+            queries = std::strtoul(argv[++i], nullptr, 10);
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-worldSize * 0.5f, worldSize * 0.5f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Engine::AABB> boxes;
+    for (size_t i = 0; i < boxCount; ++i) {
+        glm::vec3 c(pos(rng), size(rng), pos(rng));
+        glm::vec3 half(size(rng), size(rng), size(rng));
+        boxes.push_back({c - half, c + half});
+    }
+
+    Timer buildTimer;
+    Engine::BVH bvh;
+    bvh.build(boxes);
+    std::cout << boxCount << " boxes, " << bvh.getNodeCount() << " nodes, built in "
+              << buildTimer.nsPer(1) / 1e6 << " ms" << std::endl;
+
+    // Brute force is slow on big scenes; time it on a subset
+    size_t bruteQueries = std::max<size_t>(1, queries / 20);
+
+    // ---- Rays ----
+    std::vector<glm::vec3> origins, dirs;
+    for (size_t i = 0; i < queries; ++i) {
+        origins.push_back(glm::vec3(pos(rng), 1.8f, pos(rng)));
+        glm::vec3 d(unit(rng), unit(rng) * 0.2f, unit(rng));
+        dirs.push_back(glm::length(d) > 1e-3f ? glm::normalize(d) : glm::vec3(1, 0, 0));
+    }
+
+    size_t mismatches = 0;
+    size_t hits = 0;
+    Timer rayTimer;
+    for (size_t i = 0; i < queries; ++i) {
+        Engine::RayHit hit;
+        hits += bvh.raycast(origins[i], dirs[i], 100.0f, hit);
+    }
+    double rayNs = rayTimer.nsPer(queries);
+
+    Engine::AABBBatch batch;
+    for (const auto& box : boxes) batch.add(box.min, box.max);
+    std::vector<Engine::RayHit> bruteHits(bruteQueries);
+    std::vector<bool> bruteHit(bruteQueries);
+    Timer rayBruteTimer;
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        bruteHit[i] = Engine::raycastBoxes(batch, origins[i], dirs[i], 100.0f, bruteHits[i]);
+    }
+    double rayBruteNs = rayBruteTimer.nsPer(bruteQueries);
+
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        Engine::RayHit hit;
+        bool hitBvh = bvh.raycast(origins[i], dirs[i], 100.0f, hit);
+        if (hitBvh != bruteHit[i] ||
+            (hitBvh && std::abs(hit.distance - bruteHits[i].distance) > 1e-3f)) {
+            mismatches++;
+        }
+    }
+
+    std::cout << "ray:    " << rayNs << " ns/query (brute force SIMD " << rayBruteNs
+              << "), " << hits << " hits" << std::endl;
+
+    // ---- Spheres ----
+    std::vector<uint32_t> found;
+    size_t total = 0;
+    Timer sphereTimer;
+    for (size_t i = 0; i < queries; ++i) {
+        found.clear();
+        bvh.querySphere(origins[i], 3.0f, found);
+        total += found.size();
+    }
+    double sphereNs = sphereTimer.nsPer(queries);
+
+    std::vector<size_t> bruteCounts(bruteQueries);
+    Timer sphereBruteTimer;
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        size_t count = 0;
+        for (const auto& box : boxes) count += overlapsSphere(box, origins[i], 3.0f);
+        bruteCounts[i] = count;
+    }
+    double sphereBruteNs = sphereBruteTimer.nsPer(bruteQueries);
+
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        found.clear();
+        bvh.querySphere(origins[i], 3.0f, found);
+        if (found.size() != bruteCounts[i]) mismatches++;
+    }
+
+    std::cout << "sphere: " << sphereNs << " ns/query (brute force " << sphereBruteNs
+              << "), " << total << " overlaps" << std::endl;
+
+    // ---- Boxes ----
+    total = 0;
+    glm::vec3 extent(2.0f, 2.0f, 2.0f);
+    Timer boxTimer;
+    for (size_t i = 0; i < queries; ++i) {
+        found.clear();
+        bvh.queryAABB(origins[i] - extent, origins[i] + extent, found);
+        total += found.size();
+    }
+    double boxNs = boxTimer.nsPer(queries);
+
+    Timer boxBruteTimer;
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        size_t count = 0;
+        for (const auto& box : boxes) count += overlapsBox(box, origins[i] - extent, origins[i] + extent);
+        bruteCounts[i] = count;
+    }
+    double boxBruteNs = boxBruteTimer.nsPer(bruteQueries);
+
+    for (size_t i = 0; i < bruteQueries; ++i) {
+        found.clear();
+        bvh.queryAABB(origins[i] - extent, origins[i] + extent, found);
+        if (found.size() != bruteCounts[i]) mismatches++;
+    }
+
+    std::cout << "aabb:   " << boxNs << " ns/query (brute force " << boxBruteNs
+              << "), " << total << " overlaps" << std::endl;
+
+    if (mismatches) {
+        std::cerr << mismatches << " queries disagreed with brute force!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
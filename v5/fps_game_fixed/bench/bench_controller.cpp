@@ -0,0 +1,150 @@
+#include "engine/CharacterController.h"
+#include "engine/JobSystem.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Moves a crowd of capsules through a field of boxes for a number of
+// fixed steps, the way Game moves enemies, and reports the per-move cost
+// and how often the budget cut a move short. First it walks a capsule into
+// a wall built from more boxes than the candidate budget allows, and exits
+// non-zero if the capsule moved: colliding against only some of those boxes
+// is how characters end up inside walls.
+
+namespace {
+
+bool movesThroughBudgetWall(const Engine::MoveBudget& budget) {
+    // Wall face at x = 1, 0.6 wide, tiled from a few more small boxes than
+    // the budget allows; all of them are near the capsule's path
+    std::vector<Engine::AABB> tiles;
+    int rows = 4;
+    int columns = (budget.maxCandidates + 8) / rows + 1;
+    float tile = 0.6f / columns;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            float z = -0.3f + column * tile;
+            tiles.push_back({glm::vec3(1.0f, row * 0.45f, z), glm::vec3(1.2f, row * 0.45f + 0.45f, z + tile)});
+        }
+    }
+    Engine::BVH wall;
+    wall.build(tiles);
+    Engine::CharacterController controller(wall);
+
+    Engine::CharacterShape shape;
+    shape.radius = 0.4f;
+    shape.stepHeight = 0.0f;
+    Engine::MoveResult result = controller.move(glm::vec3(0.0f), glm::vec3(3.0f, 0.0f, 0.0f), shape, budget);
+    bool moved = !result.budgetExceeded || glm::length(result.position) > 0.0f;
+    std::cout << "Budget wall: " << tiles.size() << " boxes, capsule stopped at x = " << result.position.x
+              << (result.budgetExceeded ? " (over budget)" : "") << (moved ? " - MOVED" : "") << std::endl;
+    return moved;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t characters = 10000;
+    size_t boxCount = 2000;
+    int steps = 120;
+    int workers = 0;
+    Engine::MoveBudget budget;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--characters") == 0 && i + 1 < argc) {
+            characters = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--boxes") == 0 && i + 1 < argc) {
+            boxCount = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-sweeps") == 0 && i + 1 < argc) {
+            budget.maxSweeps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-candidates") == 0 && i + 1 < argc) {
+            budget.maxCandidates = std::atoi(argv[++i]);
+        }
+    }
+
+    bool wrong = movesThroughBudgetWall(budget);
+
+    // Walls, pillars and knee-high steps over a 200x200 area
+    const float half = 100.0f;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> pos(-half, half);
+    std::uniform_real_distribution<float> size(0.5f, 3.0f);
+    std::uniform_real_distribution<float> height(0.2f, 3.0f);
+
+    std::vector<Engine::AABB> boxes;
+    for (size_t i = 0; i < boxCount; ++i) {
+        glm::vec3 c(pos(rng), 0.0f, pos(rng));
+        glm::vec3 extent(size(rng), height(rng), size(rng));
+        boxes.push_back({glm::vec3(c.x - extent.x, 0.0f, c.z - extent.z),
+                         glm::vec3(c.x + extent.x, extent.y, c.z + extent.z)});
+    }
+
+    Engine::BVH bvh;
+    bvh.build(boxes);
+    Engine::CharacterController controller(bvh);
+
+    Engine::CharacterShape shape;
+    shape.radius = 0.5f;
+    shape.height = 1.0f;
+    shape.stepHeight = 0.3f;
+
+    std::vector<glm::vec3> feet(characters), goals(characters), velocity(characters, glm::vec3(0.0f));
+    for (size_t i = 0; i < characters; ++i) {
+        feet[i] = glm::vec3(pos(rng), 0.0f, pos(rng));
+        goals[i] = glm::vec3(pos(rng), 0.0f, pos(rng));
+    }
+
+    Engine::JobSystem jobs(workers);
+    const float dt = 1.0f / 60.0f;
+    std::atomic<long long> sweeps(0), candidates(0), exceeded(0), blocked(0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        jobs.parallelFor(characters, 256, [&](size_t begin, size_t end) {
+            long long localSweeps = 0, localCandidates = 0, localExceeded = 0, localBlocked = 0;
+            for (size_t i = begin; i < end; ++i) {
+                glm::vec3 toGoal = goals[i] - feet[i];
+                toGoal.y = 0.0f;
+                float distance = glm::length(toGoal);
+                if (distance > 0.1f) {
+                    velocity[i].x = toGoal.x / distance * 4.0f;
+                    velocity[i].z = toGoal.z / distance * 4.0f;
+                }
+                velocity[i].y -= 20.0f * dt;
+
+                Engine::MoveResult result = controller.move(feet[i], velocity[i] * dt, shape, budget);
+                feet[i] = result.position;
+                if (result.grounded && velocity[i].y < 0.0f) velocity[i].y = 0.0f;
+
+                localSweeps += result.sweeps;
+                localCandidates += result.candidates;
+                localExceeded += result.budgetExceeded;
+                localBlocked += result.hitWall;
+            }
+            sweeps += localSweeps;
+            candidates += localCandidates;
+            exceeded += localExceeded;
+            blocked += localBlocked;
+        });
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double moves = static_cast<double>(characters) * steps;
+    std::cout << characters << " characters x " << steps << " steps over " << boxCount
+              << " boxes, " << jobs.getWorkerCount() << " workers" << std::endl;
+    std::cout << "  " << wall * 1e9 / moves << " ns/move, "
+              << wall * 1e3 / steps << " ms/step" << std::endl;
+    std::cout << "  " << sweeps / moves << " sweeps/move, " << candidates / moves
+              << " boxes/move, " << blocked << " wall contacts, "
+              << exceeded << " moves over budget" << std::endl;
+    return wrong ? 1 : 0;
+}
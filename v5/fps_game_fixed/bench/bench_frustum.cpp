@@ -0,0 +1,137 @@
+#include "engine/Camera.h"
+#include "engine/Frustum.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Culls a field of random boxes and spheres against a camera turning in
+// place, with the dispatched (AVX2 when available) and scalar kernels.
+// Reports ns per bound and checks both agree, allowing for bounds that
+// sit within rounding error of a plane.
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double nsPer(size_t count) const {
+        return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / count;
+    }
+};
+
+// Smallest distance from a bound's test point to any plane
+float boxMargin(const Engine::Frustum& f, const Engine::AABBBatch& b, size_t i) {
+    float margin = 1e30f;
+    for (const glm::vec4& p : f.planes) {
+        float x = p.x >= 0.0f ? b.maxX()[i] : b.minX()[i];
+        float y = p.y >= 0.0f ? b.maxY()[i] : b.minY()[i];
+        float z = p.z >= 0.0f ? b.maxZ()[i] : b.minZ()[i];
+        margin = std::min(margin, std::fabs(p.x * x + p.y * y + p.z * z + p.w));
+    }
+    return margin;
+}
+
+float sphereMargin(const Engine::Frustum& f, const Engine::SphereBatch& s, size_t i) {
+    float margin = 1e30f;
+    for (const glm::vec4& p : f.planes) {
+        float d = p.x * s.x()[i] + p.y * s.y()[i] + p.z * s.z()[i] + p.w + s.radius()[i];
+        margin = std::min(margin, std::fabs(d));
+    }
+    return margin;
+}
+
+// Indices in exactly one of the two sorted lists
+template <typename Margin>
+size_t countMismatches(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+                       Margin margin, size_t& outsideTolerance) {
+    std::vector<uint32_t> diff;
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(diff));
+    for (uint32_t i : diff) {
+        if (margin(i) > 1e-3f) ++outsideTolerance;
+    }
+    return diff.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 100000;
+    int views = 64;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bounds") == 0 && i + 1 < argc) {
+            count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--views") == 0 && i + 1 < argc) {
+            views = std::atoi(argv[++i]);
+        }
+    }
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 2.0f);
+
+    Engine::AABBBatch boxes;
+    Engine::SphereBatch spheres;
+    boxes.reserve(count);
+    spheres.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 c(pos(rng), pos(rng) * 0.1f, pos(rng));
+        glm::vec3 half(size(rng), size(rng), size(rng));
+        boxes.add(c - half, c + half);
+        spheres.add(c, size(rng));
+    }
+
+    std::vector<Engine::Frustum> frusta;
+    for (int v = 0; v < views; ++v) {
+        Engine::Camera camera(glm::vec3(0.0f, 1.8f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                              360.0f * v / views, 10.0f * std::sin(v * 0.5f));
+        frusta.push_back(camera.getFrustum(16.0f / 9.0f));
+    }
+
+    std::vector<uint32_t> visible, reference;
+    size_t boxVisible = 0, sphereVisible = 0;
+    size_t mismatches = 0, outsideTolerance = 0;
+
+    Timer boxTimer;
+    for (const auto& f : frusta) { Engine::cullAABBs(f, boxes, visible); boxVisible += visible.size(); }
+    double boxNs = boxTimer.nsPer(count * frusta.size());
+
+    Timer boxScalarTimer;
+    for (const auto& f : frusta) Engine::cullAABBsScalar(f, boxes, reference);
+    double boxScalarNs = boxScalarTimer.nsPer(count * frusta.size());
+
+    Timer sphereTimer;
+    for (const auto& f : frusta) { Engine::cullSpheres(f, spheres, visible); sphereVisible += visible.size(); }
+    double sphereNs = sphereTimer.nsPer(count * frusta.size());
+
+    Timer sphereScalarTimer;
+    for (const auto& f : frusta) Engine::cullSpheresScalar(f, spheres, reference);
+    double sphereScalarNs = sphereScalarTimer.nsPer(count * frusta.size());
+
+    for (const auto& f : frusta) {
+        Engine::cullAABBs(f, boxes, visible);
+        Engine::cullAABBsScalar(f, boxes, reference);
+        mismatches += countMismatches(visible, reference,
+            [&](uint32_t i) { return boxMargin(f, boxes, i); }, outsideTolerance);
+
+        Engine::cullSpheres(f, spheres, visible);
+        Engine::cullSpheresScalar(f, spheres, reference);
+        mismatches += countMismatches(visible, reference,
+            [&](uint32_t i) { return sphereMargin(f, spheres, i); }, outsideTolerance);
+    }
+
+    std::cout << count << " bounds x " << frusta.size() << " views" << std::endl;
+    std::cout << "  AABB:   " << boxNs << " ns/bound (scalar " << boxScalarNs << "), "
+              << 100.0 * boxVisible / (count * frusta.size()) << "% visible" << std::endl;
+    std::cout << "  sphere: " << sphereNs << " ns/bound (scalar " << sphereScalarNs << "), "
+              << 100.0 * sphereVisible / (count * frusta.size()) << "% visible" << std::endl;
+    std::cout << "  " << mismatches << " boundary disagreements, "
+              << outsideTolerance << " real mismatches" << std::endl;
+
+    return outsideTolerance == 0 ? 0 : 1;
+}
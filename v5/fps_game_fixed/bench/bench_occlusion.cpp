@@ -0,0 +1,153 @@
+#include "engine/OcclusionCuller.h"
+#include "engine/BVH.h"
+#include "engine/Camera.h"
+#include "engine/Frustum.h"
+#include "engine/JobSystem.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Builds a grid of rooms joined by doorways, puts the camera in random
+// rooms and occlusion-culls a scatter of small boxes. Every box reported
+// as occluded is checked by casting rays from the eye to points on it
+// through the wall BVH; a ray that gets through means the culler was
+// wrong, and the run exits non-zero.
+
+namespace {
+
+std::vector<Engine::AABB> buildRooms(int rooms, float roomSize, float wallHeight) {
+    const float thick = 0.5f;
+    const float door = 2.0f;
+    std::vector<Engine::AABB> walls;
+
+    // Wall segment along x or z, with a doorway in the middle
+    auto addWall = [&](float x, float z, bool alongX, bool doorway) {
+        float half = roomSize * 0.5f;
+        float pieces[2][2] = { { -half, doorway ? -door * 0.5f : half },
+                               { doorway ? door * 0.5f : half, half } };
+        for (auto& piece : pieces) {
+            if (piece[1] - piece[0] <= 0.0f) continue;
+            glm::vec3 min = alongX ? glm::vec3(x + piece[0], 0.0f, z - thick * 0.5f)
+                                   : glm::vec3(x - thick * 0.5f, 0.0f, z + piece[0]);
+            glm::vec3 max = alongX ? glm::vec3(x + piece[1], wallHeight, z + thick * 0.5f)
+                                   : glm::vec3(x + thick * 0.5f, wallHeight, z + piece[1]);
+            walls.push_back({min, max});
+        }
+    };
+
+    for (int i = 0; i <= rooms; ++i) {
+        for (int j = 0; j < rooms; ++j) {
+            bool inner = i > 0 && i < rooms;
+            // Every other inner wall gets a doorway so rooms connect
+            bool doorway = inner && (i + j) % 2 == 0;
+            addWall((j + 0.5f) * roomSize, i * roomSize, true, doorway);
+            addWall(i * roomSize, (j + 0.5f) * roomSize, false, doorway);
+        }
+    }
+    return walls;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rooms = 12;
+    size_t objects = 20000;
+    int views = 50;
+    int workers = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--rooms") == 0 && i + 1 < argc) {
+            rooms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--objects") == 0 && i + 1 < argc) {
+            objects = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--views") == 0 && i + 1 < argc) {
+            views = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        }
+    }
+
+    const float roomSize = 10.0f;
+    const float extent = rooms * roomSize;
+    std::vector<Engine::AABB> walls = buildRooms(rooms, roomSize, 3.0f);
+    Engine::BVH bvh;
+    bvh.build(walls);
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Engine::AABBBatch boxes;
+    for (size_t i = 0; i < objects; ++i) {
+        glm::vec3 c(unit(rng) * extent, 0.2f + unit(rng) * 2.0f, unit(rng) * extent);
+        glm::vec3 half(0.1f + unit(rng) * 0.5f);
+        boxes.add(c - half, c + half);
+    }
+
+    Engine::JobSystem jobs(workers);
+    Engine::OcclusionCuller culler;
+    std::vector<uint32_t> visible;
+
+    double renderMs = 0.0, testNs = 0.0;
+    size_t inFrustum = 0, occluded = 0, triangles = 0, wrong = 0, rays = 0;
+
+    for (int v = 0; v < views; ++v) {
+        // Eye in the middle part of a random room
+        int rx = static_cast<int>(unit(rng) * rooms) % rooms;
+        int rz = static_cast<int>(unit(rng) * rooms) % rooms;
+        glm::vec3 eye((rx + 0.2f + unit(rng) * 0.6f) * roomSize, 1.7f,
+                      (rz + 0.2f + unit(rng) * 0.6f) * roomSize);
+        Engine::Camera camera(eye, glm::vec3(0.0f, 1.0f, 0.0f), unit(rng) * 360.0f, 0.0f);
+        const float aspect = 16.0f / 9.0f;
+        glm::mat4 viewProjection = camera.getProjectionMatrix(aspect) * camera.getViewMatrix();
+
+        auto start = std::chrono::steady_clock::now();
+        culler.render(viewProjection, eye, walls, jobs);
+        renderMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        triangles += culler.getStats().triangles;
+
+        Engine::Frustum frustum = camera.getFrustum(aspect);
+        Engine::cullAABBs(frustum, boxes, visible);
+        std::vector<uint32_t> before = visible;
+        start = std::chrono::steady_clock::now();
+        culler.cull(boxes, visible);
+        testNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        inFrustum += before.size();
+        occluded += before.size() - visible.size();
+
+        // Check every culled box: corners, face centres, centre
+        size_t kept = 0;
+        for (uint32_t index : before) {
+            if (kept < visible.size() && visible[kept] == index) { ++kept; continue; }
+
+            glm::vec3 min = boxes.getMin(index), max = boxes.getMax(index);
+            for (int s = 0; s < 27; ++s) {
+                glm::vec3 t(static_cast<float>(s % 3), static_cast<float>(s / 3 % 3), static_cast<float>(s / 9));
+                glm::vec3 point = min + (max - min) * (t * 0.5f);
+                // Points off screen may be unobstructed without being seen
+                if (!frustum.intersectsSphere(point, 0.0f)) continue;
+                glm::vec3 toPoint = point - eye;
+                float distance = glm::length(toPoint);
+                Engine::RayHit hit;
+                ++rays;
+                if (!bvh.raycast(eye, toPoint / distance, distance, hit)) {
+                    ++wrong;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::cout << walls.size() << " walls, " << objects << " objects, " << views << " views, "
+              << jobs.getWorkerCount() << " workers" << std::endl;
+    std::cout << "  render: " << renderMs / views << " ms/view ("
+              << triangles / views << " occluder triangles)" << std::endl;
+    std::cout << "  test:   " << testNs / std::max<size_t>(inFrustum, 1) << " ns/object, "
+              << 100.0 * occluded / std::max<size_t>(inFrustum, 1) << "% of "
+              << inFrustum / views << " in-frustum objects occluded" << std::endl;
+    std::cout << "  " << rays << " verification rays, " << wrong << " wrongly culled" << std::endl;
+
+    return wrong == 0 ? 0 : 1;
+}
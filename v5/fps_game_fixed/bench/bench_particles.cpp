@@ -0,0 +1,136 @@
+#include "engine/SimdKernels.h"
+#include "engine/JobSystem.h"
+#include "game/Particle.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Runs the particle step ParticleSystem::update does (life countdown,
+// gravity, position, color and size decay) over SoA arrays with every
+// kernel set this CPU supports, reports particles/second for each, and
+// checks the wide kernels agree with the scalar ones. It also checks that
+// ParticleSystem never hands out one slot twice when an emit overflows the
+// pool. Either failure exits non-zero.
+
+namespace {
+
+struct Particles {
+    std::vector<glm::vec3> positions, velocities, colors;
+    std::vector<float> life, sizes;
+};
+
+Particles makeParticles(size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    Particles p;
+    for (size_t i = 0; i < count; ++i) {
+        p.positions.push_back(glm::vec3(unit(rng), unit(rng) + 2.0f, unit(rng)) * 10.0f);
+        p.velocities.push_back(glm::vec3(unit(rng), unit(rng) + 1.0f, unit(rng)) * 3.0f);
+        p.colors.push_back(glm::vec3(unit(rng), unit(rng), unit(rng)) * 0.5f + glm::vec3(0.5f));
+        p.life.push_back(1.0f + unit(rng) * 0.5f);
+        p.sizes.push_back(0.1f + unit(rng) * 0.05f);
+    }
+    return p;
+}
+
+void step(const Engine::SimdKernels& simd, Particles& p, float dt) {
+    size_t n = p.life.size();
+    simd.add(p.life.data(), n, -dt);
+    simd.integrate(p.positions.data(), p.velocities.data(), n, glm::vec3(0.0f, -9.8f, 0.0f), dt);
+    simd.scale(&p.colors[0].x, n * 3, 0.98f);
+    simd.scale(p.sizes.data(), n, 0.98f);
+}
+
+float maxError(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b) {
+    float worst = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            float scale = std::max(1.0f, std::fabs(a[i][c]));
+            worst = std::max(worst, std::fabs(a[i][c] - b[i][c]) / scale);
+        }
+    }
+    return worst;
+}
+
+// Fills the pool to 6 short of capacity, then emits 10 at a new spot:
+// 6 particles go in free slots and 4 recycle old ones, so all 10 must show
+// up. A slot handed out twice in one emit shows as fewer.
+bool recyclesDistinctSlots() {
+    const size_t capacity = 64;
+    Game::ParticleSystem particles(capacity);
+    particles.seed(1);
+    Engine::JobSystem jobs(0);
+
+    particles.emit(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), static_cast<int>(capacity - 6));
+    particles.update(0.1f, jobs);
+    particles.emit(glm::vec3(100.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f), 10);
+
+    std::vector<Game::RenderInstance> instances;
+    particles.snapshot(1.0f, instances);
+    size_t emitted = 0;
+    for (const Game::RenderInstance& instance : instances) {
+        emitted += instance.position.x == 100.0f;
+    }
+    bool ok = particles.size() == capacity && emitted == 10;
+    std::cout << "Recycling: " << emitted << " of 10 particles emitted into a pool 6 short of full"
+              << (ok ? "" : "  DUPLICATE SLOTS") << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = 100003; // odd on purpose so the scalar tails run
+    int steps = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = std::atoi(argv[++i]);
+        }
+    }
+
+    const float dt = 1.0f / 60.0f;
+    const Particles initial = makeParticles(count);
+
+    Particles reference = initial;
+    for (int s = 0; s < steps; ++s) step(*Engine::SimdKernels::forLevel(Engine::SimdLevel::SCALAR), reference, dt);
+
+    std::cout << count << " particles x " << steps << " steps, selected kernels: "
+              << Engine::simdLevelName(Engine::SimdKernels::get().level) << std::endl;
+
+    bool ok = recyclesDistinctSlots();
+    const Engine::SimdLevel levels[] = {
+        Engine::SimdLevel::SCALAR, Engine::SimdLevel::SSE2, Engine::SimdLevel::AVX2
+    };
+    for (Engine::SimdLevel level : levels) {
+        const Engine::SimdKernels* simd = Engine::SimdKernels::forLevel(level);
+        if (!simd) {
+            std::cout << "  " << Engine::simdLevelName(level) << ": not supported" << std::endl;
+            continue;
+        }
+
+        Particles p = initial;
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < steps; ++s) step(*simd, p, dt);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // AVX2 may fuse multiply-adds, so allow rounding differences
+        float error = std::max(maxError(reference.positions, p.positions),
+                               maxError(reference.colors, p.colors));
+        bool match = error < 1e-4f;
+        ok = ok && match;
+
+        std::cout << "  " << Engine::simdLevelName(level) << ": "
+                  << static_cast<double>(count) * steps / wall / 1e6 << " M particles/s, "
+                  << wall * 1e9 / (static_cast<double>(count) * steps) << " ns/particle"
+                  << (match ? "" : "  MISMATCH vs scalar") << std::endl;
+    }
+
+    return ok ? 0 : 1;
+}
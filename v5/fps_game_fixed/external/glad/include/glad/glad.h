@@ -39,9 +39,16 @@ typedef void   (GLAPIENTRY *PFNGLGENBUFFERSPROC)(GLsizei, GLuint*);
 typedef void   (GLAPIENTRY *PFNGLBINDBUFFERPROC)(GLenum, GLuint);
 typedef void   (GLAPIENTRY *PFNGLDELETEBUFFERSPROC)(GLsizei, const GLuint*);
 typedef void   (GLAPIENTRY *PFNGLBUFFERDATAPROC)(GLenum, GLsizeiptr, const void*, GLenum);
+typedef void   (GLAPIENTRY *PFNGLBUFFERSUBDATAPROC)(GLenum, GLintptr, GLsizeiptr, const void*);
+typedef void   (GLAPIENTRY *PFNGLBINDBUFFERBASEPROC)(GLenum, GLuint, GLuint);
+typedef void*  (GLAPIENTRY *PFNGLMAPBUFFERRANGEPROC)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+typedef GLboolean (GLAPIENTRY *PFNGLUNMAPBUFFERPROC)(GLenum);
 typedef void   (GLAPIENTRY *PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint);
 typedef void   (GLAPIENTRY *PFNGLDISABLEVERTEXATTRIBARRAYPROC)(GLuint);
 typedef void   (GLAPIENTRY *PFNGLVERTEXATTRIBPOINTERPROC)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+typedef void   (GLAPIENTRY *PFNGLVERTEXATTRIBDIVISORPROC)(GLuint, GLuint);
+typedef void   (GLAPIENTRY *PFNGLVERTEXATTRIB3FPROC)(GLuint, GLfloat, GLfloat, GLfloat);
+typedef void   (GLAPIENTRY *PFNGLDRAWELEMENTSINSTANCEDPROC)(GLenum, GLsizei, GLenum, const void*, GLsizei);
 typedef GLuint (GLAPIENTRY *PFNGLCREATESHADERPROC)(GLenum);
 typedef void   (GLAPIENTRY *PFNGLDELETESHADERPROC)(GLuint);
 typedef void   (GLAPIENTRY *PFNGLSHADERSOURCEPROC)(GLuint, GLsizei, const GLchar* const*, const GLint*);
@@ -55,7 +62,13 @@ typedef void   (GLAPIENTRY *PFNGLLINKPROGRAMPROC)(GLuint);
 typedef void   (GLAPIENTRY *PFNGLGETPROGRAMIVPROC)(GLuint, GLenum, GLint*);
 typedef void   (GLAPIENTRY *PFNGLGETPROGRAMINFOLOGPROC)(GLuint, GLsizei, GLsizei*, GLchar*);
 typedef void   (GLAPIENTRY *PFNGLUSEPROGRAMPROC)(GLuint);
+typedef void   (GLAPIENTRY *PFNGLGETPROGRAMBINARYPROC)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void   (GLAPIENTRY *PFNGLPROGRAMBINARYPROC)(GLuint, GLenum, const void*, GLsizei);
+typedef void   (GLAPIENTRY *PFNGLPROGRAMPARAMETERIPROC)(GLuint, GLenum, GLint);
+typedef void   (GLAPIENTRY *PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint);
 typedef GLint  (GLAPIENTRY *PFNGLGETUNIFORMLOCATIONPROC)(GLuint, const GLchar*);
+typedef GLuint (GLAPIENTRY *PFNGLGETUNIFORMBLOCKINDEXPROC)(GLuint, const GLchar*);
+typedef void   (GLAPIENTRY *PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint, GLuint, GLuint);
 typedef void   (GLAPIENTRY *PFNGLUNIFORM1IPROC)(GLint, GLint);
 typedef void   (GLAPIENTRY *PFNGLUNIFORM1FPROC)(GLint, GLfloat);
 typedef void   (GLAPIENTRY *PFNGLUNIFORM3FVPROC)(GLint, GLsizei, const GLfloat*);
@@ -74,9 +87,16 @@ extern PFNGLGENBUFFERSPROC              glad_glGenBuffers;
 extern PFNGLBINDBUFFERPROC              glad_glBindBuffer;
 extern PFNGLDELETEBUFFERSPROC           glad_glDeleteBuffers;
 extern PFNGLBUFFERDATAPROC              glad_glBufferData;
+extern PFNGLBUFFERSUBDATAPROC           glad_glBufferSubData;
+extern PFNGLBINDBUFFERBASEPROC          glad_glBindBufferBase;
+extern PFNGLMAPBUFFERRANGEPROC          glad_glMapBufferRange;
+extern PFNGLUNMAPBUFFERPROC             glad_glUnmapBuffer;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glad_glEnableVertexAttribArray;
 extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glad_glDisableVertexAttribArray;
 extern PFNGLVERTEXATTRIBPOINTERPROC     glad_glVertexAttribPointer;
+extern PFNGLVERTEXATTRIBDIVISORPROC     glad_glVertexAttribDivisor;
+extern PFNGLVERTEXATTRIB3FPROC          glad_glVertexAttrib3f;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC   glad_glDrawElementsInstanced;
 extern PFNGLCREATESHADERPROC            glad_glCreateShader;
 extern PFNGLDELETESHADERPROC            glad_glDeleteShader;
 extern PFNGLSHADERSOURCEPROC            glad_glShaderSource;
@@ -90,7 +110,13 @@ extern PFNGLLINKPROGRAMPROC             glad_glLinkProgram;
 extern PFNGLGETPROGRAMIVPROC            glad_glGetProgramiv;
 extern PFNGLGETPROGRAMINFOLOGPROC       glad_glGetProgramInfoLog;
 extern PFNGLUSEPROGRAMPROC              glad_glUseProgram;
+extern PFNGLGETPROGRAMBINARYPROC        glad_glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC           glad_glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC       glad_glProgramParameteri;
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR; /* NULL without the extension */
 extern PFNGLGETUNIFORMLOCATIONPROC      glad_glGetUniformLocation;
+extern PFNGLGETUNIFORMBLOCKINDEXPROC    glad_glGetUniformBlockIndex;
+extern PFNGLUNIFORMBLOCKBINDINGPROC     glad_glUniformBlockBinding;
 extern PFNGLUNIFORM1IPROC               glad_glUniform1i;
 extern PFNGLUNIFORM1FPROC               glad_glUniform1f;
 extern PFNGLUNIFORM3FVPROC              glad_glUniform3fv;
@@ -109,9 +135,16 @@ extern PFNGLBLENDFUNCSEPARATEPROC       glad_glBlendFuncSeparate;
 #define glBindBuffer              glad_glBindBuffer
 #define glDeleteBuffers           glad_glDeleteBuffers
 #define glBufferData              glad_glBufferData
+#define glBufferSubData           glad_glBufferSubData
+#define glBindBufferBase          glad_glBindBufferBase
+#define glMapBufferRange          glad_glMapBufferRange
+#define glUnmapBuffer             glad_glUnmapBuffer
 #define glEnableVertexAttribArray glad_glEnableVertexAttribArray
 #define glDisableVertexAttribArray glad_glDisableVertexAttribArray
 #define glVertexAttribPointer     glad_glVertexAttribPointer
+#define glVertexAttribDivisor     glad_glVertexAttribDivisor
+#define glVertexAttrib3f          glad_glVertexAttrib3f
+#define glDrawElementsInstanced   glad_glDrawElementsInstanced
 #define glCreateShader            glad_glCreateShader
 #define glDeleteShader            glad_glDeleteShader
 #define glShaderSource            glad_glShaderSource
@@ -125,7 +158,13 @@ extern PFNGLBLENDFUNCSEPARATEPROC       glad_glBlendFuncSeparate;
 #define glGetProgramiv            glad_glGetProgramiv
 #define glGetProgramInfoLog       glad_glGetProgramInfoLog
 #define glUseProgram              glad_glUseProgram
+#define glGetProgramBinary        glad_glGetProgramBinary
+#define glProgramBinary           glad_glProgramBinary
+#define glProgramParameteri       glad_glProgramParameteri
+#define glMaxShaderCompilerThreadsKHR glad_glMaxShaderCompilerThreadsKHR
 #define glGetUniformLocation      glad_glGetUniformLocation
+#define glGetUniformBlockIndex    glad_glGetUniformBlockIndex
+#define glUniformBlockBinding     glad_glUniformBlockBinding
 #define glUniform1i               glad_glUniform1i
 #define glUniform1f               glad_glUniform1f
 #define glUniform3fv              glad_glUniform3fv
@@ -149,6 +188,27 @@ extern PFNGLBLENDFUNCSEPARATEPROC       glad_glBlendFuncSeparate;
 #ifndef GL_DYNAMIC_DRAW
 #define GL_DYNAMIC_DRAW           0x88E8
 #endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW            0x88E0
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT             0x140B
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER    0x88EC
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT          0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER         0x8A11
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX          0xFFFFFFFFu
+#endif
 #ifndef GL_VERTEX_SHADER
 #define GL_VERTEX_SHADER          0x8B31
 #endif
@@ -164,9 +224,27 @@ extern PFNGLBLENDFUNCSEPARATEPROC       glad_glBlendFuncSeparate;
 #ifndef GL_INFO_LOG_LENGTH
 #define GL_INFO_LOG_LENGTH        0x8B84
 #endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH  0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR  0x91B1
+#endif
 #ifndef GL_TEXTURE0
 #define GL_TEXTURE0               0x84C0
 #endif
+#ifndef GL_TEXTURE_BASE_LEVEL
+#define GL_TEXTURE_BASE_LEVEL     0x813C
+#endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL      0x813D
+#endif
 #ifndef GL_GENERATE_MIPMAP
 #define GL_GENERATE_MIPMAP        0x8191
 #endif
@@ -12,9 +12,16 @@ PFNGLGENBUFFERSPROC              glad_glGenBuffers              = NULL;
 PFNGLBINDBUFFERPROC              glad_glBindBuffer              = NULL;
 PFNGLDELETEBUFFERSPROC           glad_glDeleteBuffers           = NULL;
 PFNGLBUFFERDATAPROC              glad_glBufferData              = NULL;
+PFNGLBUFFERSUBDATAPROC           glad_glBufferSubData           = NULL;
+PFNGLBINDBUFFERBASEPROC          glad_glBindBufferBase          = NULL;
+PFNGLMAPBUFFERRANGEPROC          glad_glMapBufferRange          = NULL;
+PFNGLUNMAPBUFFERPROC             glad_glUnmapBuffer             = NULL;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glad_glEnableVertexAttribArray = NULL;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC glad_glDisableVertexAttribArray = NULL;
 PFNGLVERTEXATTRIBPOINTERPROC     glad_glVertexAttribPointer     = NULL;
+PFNGLVERTEXATTRIBDIVISORPROC     glad_glVertexAttribDivisor     = NULL;
+PFNGLVERTEXATTRIB3FPROC          glad_glVertexAttrib3f          = NULL;
+PFNGLDRAWELEMENTSINSTANCEDPROC   glad_glDrawElementsInstanced   = NULL;
 PFNGLCREATESHADERPROC            glad_glCreateShader            = NULL;
 PFNGLDELETESHADERPROC            glad_glDeleteShader            = NULL;
 PFNGLSHADERSOURCEPROC            glad_glShaderSource            = NULL;
@@ -28,7 +35,13 @@ PFNGLLINKPROGRAMPROC             glad_glLinkProgram             = NULL;
 PFNGLGETPROGRAMIVPROC            glad_glGetProgramiv            = NULL;
 PFNGLGETPROGRAMINFOLOGPROC       glad_glGetProgramInfoLog       = NULL;
 PFNGLUSEPROGRAMPROC              glad_glUseProgram              = NULL;
+PFNGLGETPROGRAMBINARYPROC        glad_glGetProgramBinary        = NULL;
+PFNGLPROGRAMBINARYPROC           glad_glProgramBinary           = NULL;
+PFNGLPROGRAMPARAMETERIPROC       glad_glProgramParameteri       = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = NULL;
 PFNGLGETUNIFORMLOCATIONPROC      glad_glGetUniformLocation      = NULL;
+PFNGLGETUNIFORMBLOCKINDEXPROC    glad_glGetUniformBlockIndex    = NULL;
+PFNGLUNIFORMBLOCKBINDINGPROC     glad_glUniformBlockBinding     = NULL;
 PFNGLUNIFORM1IPROC               glad_glUniform1i               = NULL;
 PFNGLUNIFORM1FPROC               glad_glUniform1f               = NULL;
 PFNGLUNIFORM3FVPROC              glad_glUniform3fv              = NULL;
@@ -41,6 +54,9 @@ PFNGLBLENDFUNCSEPARATEPROC       glad_glBlendFuncSeparate       = NULL;
 
 #define LOAD(name) glad_##name = (void*) SDL_GL_GetProcAddress(#name); \
     if (!glad_##name) { fprintf(stderr, "WARNING: Could not load " #name "\n"); }
+/* Extension entry points; callers check the extension string too, since
+   some platforms return a pointer for anything */
+#define LOAD_OPTIONAL(name, symbol) glad_##name = (void*) SDL_GL_GetProcAddress(symbol);
 
 int gladLoadGL(void) {
     LOAD(glGenVertexArrays)
@@ -50,9 +66,16 @@ int gladLoadGL(void) {
     LOAD(glBindBuffer)
     LOAD(glDeleteBuffers)
     LOAD(glBufferData)
+    LOAD(glBufferSubData)
+    LOAD(glBindBufferBase)
+    LOAD(glMapBufferRange)
+    LOAD(glUnmapBuffer)
     LOAD(glEnableVertexAttribArray)
     LOAD(glDisableVertexAttribArray)
     LOAD(glVertexAttribPointer)
+    LOAD(glVertexAttribDivisor)
+    LOAD(glVertexAttrib3f)
+    LOAD(glDrawElementsInstanced)
     LOAD(glCreateShader)
     LOAD(glDeleteShader)
     LOAD(glShaderSource)
@@ -66,7 +89,12 @@ int gladLoadGL(void) {
     LOAD(glGetProgramiv)
     LOAD(glGetProgramInfoLog)
     LOAD(glUseProgram)
+    LOAD(glGetProgramBinary)
+    LOAD(glProgramBinary)
+    LOAD(glProgramParameteri)
     LOAD(glGetUniformLocation)
+    LOAD(glGetUniformBlockIndex)
+    LOAD(glUniformBlockBinding)
     LOAD(glUniform1i)
     LOAD(glUniform1f)
     LOAD(glUniform3fv)
@@ -77,6 +105,11 @@ int gladLoadGL(void) {
     LOAD(glBlendEquation)
     LOAD(glBlendFuncSeparate)
 
+    LOAD_OPTIONAL(glMaxShaderCompilerThreadsKHR, "glMaxShaderCompilerThreadsKHR")
+    if (!glad_glMaxShaderCompilerThreadsKHR) {
+        LOAD_OPTIONAL(glMaxShaderCompilerThreadsKHR, "glMaxShaderCompilerThreadsARB")
+    }
+
     if (!glad_glGenVertexArrays || !glad_glCreateShader || !glad_glCreateProgram) {
         fprintf(stderr, "ERROR: Failed to load essential OpenGL 3.3 functions.\n");
         fprintf(stderr, "Make sure your GPU supports OpenGL 3.3 and drivers are up-to-date.\n");
@@ -134,6 +134,11 @@ namespace glm {
         return a.x*b.x + a.y*b.y + a.z*b.z;
     }
 
+    template<typename T>
+    tvec3<T> mix(const tvec3<T>& a, const tvec3<T>& b, T t) {
+        return a + (b - a) * t;
+    }
+
     template<typename T>
     tvec3<T> cross(const tvec3<T>& a, const tvec3<T>& b) {
         return tvec3<T>(
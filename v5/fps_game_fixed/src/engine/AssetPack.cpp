@@ -0,0 +1,419 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+
+static const char kMagic[4] = {'F', 'P', 'A', 'K'};
+static const uint16_t kVersion = 1;
+
+static_assert(sizeof(AssetPackHeader) == 32, "pack header layout changed");
+static_assert(sizeof(AssetPackEntry) == 40, "pack entry layout changed");
+
+namespace {
+
+const size_t kMinMatch = 4;
+const size_t kMaxOffset = 65535;
+const int kHashBits = 14;
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+bool readLength(const uint8_t*& src, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (src >= end) return false;
+        byte = *src++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Token: high nibble literal count, low nibble match length - 4; 15 in
+// either means more length bytes follow. The last sequence has no match.
+void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount,
+                   size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) |
+                                       std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15) writeLength(out, literalCount - 15);
+    out.insert(out.end(), literals, literals + literalCount);
+    if (!matchLength) return;
+
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) writeLength(out, matchCode - 15);
+}
+
+} // namespace
+
+uint64_t hashAssetName(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void lzCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(size / 2 + 16);
+
+    // Last position each 4-byte sequence was seen at
+    const size_t none = static_cast<size_t>(-1);
+    std::vector<size_t> table(size_t(1) << kHashBits, none);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + kMinMatch <= size) {
+        uint32_t sequence;
+        std::memcpy(&sequence, src + pos, sizeof(sequence));
+        uint32_t slot = (sequence * 2654435761u) >> (32 - kHashBits);
+        size_t candidate = table[slot];
+        table[slot] = pos;
+
+        if (candidate == none || pos - candidate > kMaxOffset ||
+            std::memcmp(src + candidate, src + pos, kMinMatch) != 0) {
+            ++pos;
+            continue;
+        }
+
+        size_t length = kMinMatch;
+        while (pos + length < size && src[candidate + length] == src[pos + length]) {
+            ++length;
+        }
+        writeSequence(out, src + anchor, pos - anchor, pos - candidate, length);
+        pos += length;
+        anchor = pos;
+    }
+    if (anchor < size) {
+        writeSequence(out, src + anchor, size - anchor, 0, 0);
+    }
+}
+
+bool lzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    const uint8_t* end = src + size;
+    size_t written = 0;
+
+    while (src < end) {
+        uint8_t token = *src++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(src, end, literalCount)) return false;
+        if (literalCount > static_cast<size_t>(end - src) || literalCount > dstSize - written) return false;
+        std::memcpy(dst + written, src, literalCount);
+        src += literalCount;
+        written += literalCount;
+        if (src == end) break;
+
+        if (end - src < 2) return false;
+        size_t offset = src[0] | (static_cast<size_t>(src[1]) << 8);
+        src += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(src, end, matchLength)) return false;
+        matchLength += kMinMatch;
+        if (offset == 0 || offset > written || matchLength > dstSize - written) return false;
+
+        // Byte by byte: a match may overlap the bytes it is producing
+        const uint8_t* from = dst + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            dst[written + i] = from[i];
+        }
+        written += matchLength;
+    }
+    return written == dstSize;
+}
+
+// ---- AssetPack ----
+
+AssetPack::AssetPack()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_entries(nullptr)
+    , m_entryCount(0)
+    , m_names(nullptr)
+#ifdef _WIN32
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open asset pack " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(AssetPackHeader))) {
+        std::cerr << "Asset pack " << path << " is truncated" << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    // The mapping keeps the file open
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    void* data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        std::cerr << "Failed to map asset pack " << path << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cerr << "Failed to open asset pack " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(AssetPackHeader))) {
+        std::cerr << "Asset pack " << path << " is truncated" << std::endl;
+        ::close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map asset pack " << path << std::endl;
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    // Start reading the whole pack in now rather than page by page as
+    // assets are first touched
+    madvise(data, m_size, MADV_WILLNEED);
+#endif
+    m_data = static_cast<const uint8_t*>(data);
+
+    AssetPackHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        std::cerr << "Asset pack " << path << " has an unknown format" << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t indexEnd = sizeof(AssetPackHeader) + uint64_t(header.entryCount) * sizeof(AssetPackEntry);
+    bool valid = indexEnd <= m_size && header.namesOffset >= indexEnd &&
+                 header.namesOffset <= m_size && header.namesSize <= m_size - header.namesOffset;
+    m_entries = reinterpret_cast<const AssetPackEntry*>(m_data + sizeof(AssetPackHeader));
+    m_entryCount = header.entryCount;
+    m_names = reinterpret_cast<const char*>(m_data + header.namesOffset);
+
+    // Checked once here so lookups can trust the index
+    for (size_t i = 0; valid && i < m_entryCount; ++i) {
+        const AssetPackEntry& entry = m_entries[i];
+        valid = entry.offset <= m_size && entry.storedSize <= m_size - entry.offset &&
+                uint64_t(entry.nameOffset) + entry.nameLength <= header.namesSize &&
+                (i == 0 || m_entries[i - 1].hash <= entry.hash);
+        if (entry.compression == static_cast<uint8_t>(AssetCompression::NONE)) {
+            valid = valid && entry.storedSize == entry.size;
+        } else if (entry.compression != static_cast<uint8_t>(AssetCompression::LZ)) {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Asset pack " << path << " is corrupt" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::close() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+}
+
+const AssetPackEntry* AssetPack::findEntry(const std::string& name) const {
+    uint64_t hash = hashAssetName(name);
+    const AssetPackEntry* end = m_entries + m_entryCount;
+    const AssetPackEntry* entry = std::lower_bound(m_entries, end, hash,
+        [](const AssetPackEntry& e, uint64_t h) { return e.hash < h; });
+
+    for (; entry != end && entry->hash == hash; ++entry) {
+        if (entry->nameLength == name.size() &&
+            std::memcmp(m_names + entry->nameOffset, name.data(), name.size()) == 0) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* AssetPack::find(const std::string& name, size_t& size) const {
+    const AssetPackEntry* entry = findEntry(name);
+    if (!entry || entry->compression != static_cast<uint8_t>(AssetCompression::NONE)) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(entry->size);
+    return m_data + entry->offset;
+}
+
+bool AssetPack::read(const std::string& name, std::vector<uint8_t>& out) const {
+    const AssetPackEntry* entry = findEntry(name);
+    if (!entry) {
+        return false;
+    }
+
+    const uint8_t* stored = m_data + entry->offset;
+    if (entry->compression == static_cast<uint8_t>(AssetCompression::NONE)) {
+        out.assign(stored, stored + entry->size);
+        return true;
+    }
+
+    out.resize(static_cast<size_t>(entry->size));
+    if (!lzDecompress(stored, static_cast<size_t>(entry->storedSize), out.data(), out.size())) {
+        std::cerr << "Asset " << name << " failed to decompress" << std::endl;
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+std::string AssetPack::getEntryName(size_t index) const {
+    const AssetPackEntry& entry = m_entries[index];
+    return std::string(m_names + entry.nameOffset, entry.nameLength);
+}
+
+// ---- AssetPackWriter ----
+
+AssetPackWriter::AssetPackWriter(uint32_t alignment)
+    : m_alignment(alignment ? alignment : 1)
+{
+}
+
+bool AssetPackWriter::add(const std::string& name, std::vector<uint8_t> data, bool compress) {
+    if (name.empty() || name.size() > 0xFFFF) {
+        return false;
+    }
+
+    Asset asset;
+    asset.name = name;
+    asset.hash = hashAssetName(name);
+    asset.size = data.size();
+    asset.compression = AssetCompression::NONE;
+
+    if (compress && !data.empty()) {
+        std::vector<uint8_t> packed;
+        lzCompress(data.data(), data.size(), packed);
+        if (packed.size() <= data.size() - data.size() / 8) {
+            asset.compression = AssetCompression::LZ;
+            data.swap(packed);
+        }
+    }
+    asset.data = std::move(data);
+    m_assets.push_back(std::move(asset));
+    return true;
+}
+
+bool AssetPackWriter::write(const std::string& path) const {
+    std::vector<const Asset*> sorted;
+    sorted.reserve(m_assets.size());
+    for (const Asset& asset : m_assets) {
+        sorted.push_back(&asset);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Asset* a, const Asset* b) {
+        return a->hash != b->hash ? a->hash < b->hash : a->name < b->name;
+    });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i]->name == sorted[i - 1]->name) {
+            std::cerr << "Asset pack: " << sorted[i]->name << " added twice" << std::endl;
+            return false;
+        }
+    }
+
+    AssetPackHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+    header.alignment = m_alignment;
+    header.namesOffset = sizeof(AssetPackHeader) + sorted.size() * sizeof(AssetPackEntry);
+
+    std::vector<AssetPackEntry> entries(sorted.size());
+    std::string names;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        entries[i].hash = sorted[i]->hash;
+        entries[i].size = sorted[i]->size;
+        entries[i].storedSize = sorted[i]->data.size();
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint16_t>(sorted[i]->name.size());
+        entries[i].compression = static_cast<uint8_t>(sorted[i]->compression);
+        names += sorted[i]->name;
+    }
+    header.namesSize = names.size();
+
+    // Blobs follow the names, each on the alignment boundary
+    auto align = [this](uint64_t offset) {
+        return (offset + m_alignment - 1) / m_alignment * m_alignment;
+    };
+    uint64_t offset = header.namesOffset + header.namesSize;
+    for (AssetPackEntry& entry : entries) {
+        entry.offset = align(offset);
+        offset = entry.offset + entry.storedSize;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create asset pack " << path << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackEntry));
+    out.write(names.data(), names.size());
+
+    uint64_t written = header.namesOffset + header.namesSize;
+    const std::vector<char> padding(m_alignment, 0);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        out.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - written));
+        out.write(reinterpret_cast<const char*>(sorted[i]->data.data()), sorted[i]->data.size());
+        written = entries[i].offset + entries[i].storedSize;
+    }
+
+    if (!out) {
+        std::cerr << "Failed to write asset pack " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Engine
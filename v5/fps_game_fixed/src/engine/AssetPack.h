@@ -0,0 +1,117 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// Pack layout (native byte order, which is little-endian on every target
+// we build for):
+//   header   "FPAK" u16 version, u16 flags, u32 entry count, u32 blob
+//            alignment, u64 names offset, u64 names size
+//   index    entry count x AssetPackEntry, sorted by name hash
+//   names    concatenated entry names, not terminated
+//   blobs    one per entry, each starting on the blob alignment
+struct AssetPackHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct AssetPackEntry {
+    uint64_t hash;       // FNV-1a of the name
+    uint64_t offset;     // of the blob, from the start of the pack
+    uint64_t size;       // unpacked bytes
+    uint64_t storedSize; // bytes in the pack; equals size when stored raw
+    uint32_t nameOffset; // into the names block
+    uint16_t nameLength;
+    uint8_t compression; // AssetCompression
+    uint8_t reserved;
+};
+
+enum class AssetCompression : uint8_t { NONE = 0, LZ = 1 };
+
+uint64_t hashAssetName(const std::string& name);
+
+// Read-only view of a pack file. The whole file is memory-mapped once, so
+// reading an asset is a binary search and, for raw entries, a pointer into
+// the mapping: no per-asset open/read calls and no copies. Lookups are
+// const and safe from any thread while the pack is open.
+class AssetPack {
+public:
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    bool contains(const std::string& name) const { return findEntry(name) != nullptr; }
+    // Points into the mapping and stays valid until close(). Returns
+    // nullptr for missing entries and for compressed ones, which need read().
+    const uint8_t* find(const std::string& name, size_t& size) const;
+    // Copies (or unpacks) the entry into 'out'
+    bool read(const std::string& name, std::vector<uint8_t>& out) const;
+
+    size_t getEntryCount() const { return m_entryCount; }
+    const AssetPackEntry& getEntry(size_t index) const { return m_entries[index]; }
+    std::string getEntryName(size_t index) const;
+    size_t getMappedBytes() const { return m_size; }
+
+private:
+    const AssetPackEntry* findEntry(const std::string& name) const;
+
+    const uint8_t* m_data;
+    size_t m_size;
+    const AssetPackEntry* m_entries;
+    size_t m_entryCount;
+    const char* m_names;
+#ifdef _WIN32
+    void* m_mapping; // file mapping HANDLE
+#endif
+};
+
+// Builds a pack in memory and writes it out in one go
+class AssetPackWriter {
+public:
+    explicit AssetPackWriter(uint32_t alignment = 64);
+
+    // Compressed entries are stored raw anyway when packing saves less
+    // than an eighth of their size. Names are case-sensitive, '/'-separated
+    // and at most 65535 bytes; write() rejects duplicates.
+    bool add(const std::string& name, std::vector<uint8_t> data, bool compress = false);
+    bool write(const std::string& path) const;
+
+    size_t getEntryCount() const { return m_assets.size(); }
+
+private:
+    struct Asset {
+        std::string name;
+        uint64_t hash;
+        uint64_t size;
+        AssetCompression compression;
+        std::vector<uint8_t> data;
+    };
+
+    uint32_t m_alignment;
+    std::vector<Asset> m_assets;
+};
+
+// LZ77 block codec used for compressed entries: literal runs and
+// back-references of at least 4 bytes within the last 64 KB
+void lzCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& out);
+bool lzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize);
+
+} // namespace Engine
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,307 @@
+#include "BVH.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+const int kBins = 12;
+// Traversal stacks are sized by this; build() never goes deeper
+const int kMaxDepth = 64;
+
+float halfArea(const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 e = max - min;
+    return e.x * e.y + e.y * e.z + e.z * e.x;
+}
+
+glm::vec3 minOf(const glm::vec3& a, const glm::vec3& b) {
+    return glm::vec3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+}
+
+glm::vec3 maxOf(const glm::vec3& a, const glm::vec3& b) {
+    return glm::vec3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+}
+
+// Entry distance of the ray into the box, or infinity on a miss
+float slab(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin,
+           const glm::vec3& invDir, float maxDistance) {
+    float tx1 = (min.x - origin.x) * invDir.x, tx2 = (max.x - origin.x) * invDir.x;
+    float ty1 = (min.y - origin.y) * invDir.y, ty2 = (max.y - origin.y) * invDir.y;
+    float tz1 = (min.z - origin.z) * invDir.z, tz2 = (max.z - origin.z) * invDir.z;
+
+    float tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)),
+                           std::max(std::min(tz1, tz2), 0.0f));
+    float tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                          std::min(std::max(tz1, tz2), maxDistance));
+
+    return tNear <= tFar ? tNear : std::numeric_limits<float>::infinity();
+}
+
+} // namespace
+
+BVH::BVH() {
+}
+
+void BVH::clear() {
+    m_nodes.clear();
+    m_indices.clear();
+    m_boxes.clear();
+    m_centroids.clear();
+}
+
+void BVH::build(const std::vector<AABB>& boxes) {
+    clear();
+    if (boxes.empty()) return;
+
+    m_boxes = boxes;
+    m_centroids.reserve(boxes.size());
+    m_indices.reserve(boxes.size());
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        m_centroids.push_back((boxes[i].min + boxes[i].max) * 0.5f);
+        m_indices.push_back(i);
+    }
+
+    // A binary tree over n leaves never needs more than 2n - 1 nodes
+    m_nodes.reserve(boxes.size() * 2 - 1);
+    m_nodes.push_back(Node{glm::vec3(0.0f), 0, glm::vec3(0.0f), static_cast<uint32_t>(boxes.size())});
+    updateBounds(0);
+    subdivide(0, 0);
+}
+
+void BVH::updateBounds(uint32_t nodeIndex) {
+    Node& node = m_nodes[nodeIndex];
+    node.min = glm::vec3(std::numeric_limits<float>::max());
+    node.max = glm::vec3(-std::numeric_limits<float>::max());
+
+    for (uint32_t i = 0; i < node.count; ++i) {
+        const AABB& box = m_boxes[m_indices[node.leftOrFirst + i]];
+        node.min = minOf(node.min, box.min);
+        node.max = maxOf(node.max, box.max);
+    }
+}
+
+void BVH::subdivide(uint32_t nodeIndex, int depth) {
+    Node node = m_nodes[nodeIndex];
+    if (node.count <= 1 || depth >= kMaxDepth - 1) return;
+
+    // Bin centroids along each axis and sweep for the cheapest split
+    int bestAxis = -1;
+    int bestBin = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    float bestMin = 0.0f, bestScale = 0.0f;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        float cMin = std::numeric_limits<float>::max();
+        float cMax = -std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < node.count; ++i) {
+            float c = m_centroids[m_indices[node.leftOrFirst + i]][axis];
+            cMin = std::min(cMin, c);
+            cMax = std::max(cMax, c);
+        }
+        if (cMax <= cMin) continue;
+
+        glm::vec3 binMin[kBins], binMax[kBins];
+        int binCount[kBins] = {0};
+        for (int b = 0; b < kBins; ++b) {
+            binMin[b] = glm::vec3(std::numeric_limits<float>::max());
+            binMax[b] = glm::vec3(-std::numeric_limits<float>::max());
+        }
+
+        float scale = kBins / (cMax - cMin);
+        for (uint32_t i = 0; i < node.count; ++i) {
+            uint32_t index = m_indices[node.leftOrFirst + i];
+            int b = std::min(kBins - 1, static_cast<int>((m_centroids[index][axis] - cMin) * scale));
+            binCount[b]++;
+            binMin[b] = minOf(binMin[b], m_boxes[index].min);
+            binMax[b] = maxOf(binMax[b], m_boxes[index].max);
+        }
+
+        // Areas and counts left of each plane, then right of it
+        float leftArea[kBins - 1], rightArea[kBins - 1];
+        int leftCount[kBins - 1], rightCount[kBins - 1];
+        glm::vec3 lMin(std::numeric_limits<float>::max()), lMax(-std::numeric_limits<float>::max());
+        glm::vec3 rMin = lMin, rMax = lMax;
+        int lSum = 0, rSum = 0;
+        for (int b = 0; b < kBins - 1; ++b) {
+            lSum += binCount[b];
+            leftCount[b] = lSum;
+            if (binCount[b]) {
+                lMin = minOf(lMin, binMin[b]);
+                lMax = maxOf(lMax, binMax[b]);
+            }
+            leftArea[b] = lSum ? halfArea(lMin, lMax) : 0.0f;
+
+            int r = kBins - 1 - b;
+            rSum += binCount[r];
+            rightCount[r - 1] = rSum;
+            if (binCount[r]) {
+                rMin = minOf(rMin, binMin[r]);
+                rMax = maxOf(rMax, binMax[r]);
+            }
+            rightArea[r - 1] = rSum ? halfArea(rMin, rMax) : 0.0f;
+        }
+
+        for (int b = 0; b < kBins - 1; ++b) {
+            float cost = leftCount[b] * leftArea[b] + rightCount[b] * rightArea[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b;
+                bestMin = cMin;
+                bestScale = scale;
+            }
+        }
+    }
+
+    // Keep the leaf if no split beats testing every box in it
+    float leafCost = node.count * halfArea(node.min, node.max);
+    if (bestAxis < 0 || bestCost >= leafCost) return;
+
+    // Partition the index range around the chosen plane
+    uint32_t i = node.leftOrFirst;
+    uint32_t j = i + node.count;
+    while (i < j) {
+        float c = m_centroids[m_indices[i]][bestAxis];
+        int b = std::min(kBins - 1, static_cast<int>((c - bestMin) * bestScale));
+        if (b <= bestBin) {
+            ++i;
+        } else {
+            std::swap(m_indices[i], m_indices[--j]);
+        }
+    }
+
+    uint32_t leftCount = i - node.leftOrFirst;
+    if (leftCount == 0 || leftCount == node.count) return;
+
+    uint32_t left = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{glm::vec3(0.0f), node.leftOrFirst, glm::vec3(0.0f), leftCount});
+    m_nodes.push_back(Node{glm::vec3(0.0f), i, glm::vec3(0.0f), node.count - leftCount});
+    m_nodes[nodeIndex].leftOrFirst = left;
+    m_nodes[nodeIndex].count = 0;
+
+    updateBounds(left);
+    updateBounds(left + 1);
+    subdivide(left, depth + 1);
+    subdivide(left + 1, depth + 1);
+}
+
+bool BVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                  RayHit& hit) const {
+    if (m_nodes.empty()) return false;
+
+    glm::vec3 dir = glm::normalize(direction);
+    glm::vec3 invDir = safeInverseDirection(dir);
+    const float inf = std::numeric_limits<float>::infinity();
+
+    float best = inf;
+    uint32_t bestBox = 0;
+
+    uint32_t stack[kMaxDepth];
+    int top = 0;
+    if (slab(m_nodes[0].min, m_nodes[0].max, origin, invDir, maxDistance) == inf) return false;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t index = m_indices[node.leftOrFirst + i];
+                float t = slab(m_boxes[index].min, m_boxes[index].max, origin, invDir, maxDistance);
+                if (t < best) {
+                    best = t;
+                    bestBox = index;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first; skip children behind the best hit
+        uint32_t near = node.leftOrFirst;
+        uint32_t far = near + 1;
+        float tNear = slab(m_nodes[near].min, m_nodes[near].max, origin, invDir, maxDistance);
+        float tFar = slab(m_nodes[far].min, m_nodes[far].max, origin, invDir, maxDistance);
+        if (tFar < tNear) {
+            std::swap(near, far);
+            std::swap(tNear, tFar);
+        }
+
+        if (tFar < best) stack[top++] = far;
+        if (tNear < best) stack[top++] = near;
+    }
+
+    if (best == inf) return false;
+
+    hit.distance = best;
+    hit.point = origin + dir * best;
+    hit.index = bestBox;
+    hit.normal = boxEntryNormal(m_boxes[bestBox].min, m_boxes[bestBox].max, origin, dir, best);
+    return true;
+}
+
+void BVH::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const {
+    if (m_nodes.empty()) return;
+
+    float radiusSq = radius * radius;
+    auto overlaps = [&](const glm::vec3& min, const glm::vec3& max) {
+        glm::vec3 closest = minOf(maxOf(center, min), max);
+        glm::vec3 d = closest - center;
+        return glm::dot(d, d) <= radiusSq;
+    };
+
+    uint32_t stack[kMaxDepth];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (!overlaps(node.min, node.max)) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t index = m_indices[node.leftOrFirst + i];
+                if (overlaps(m_boxes[index].min, m_boxes[index].max)) {
+                    out.push_back(index);
+                }
+            }
+        } else {
+            stack[top++] = node.leftOrFirst + 1;
+            stack[top++] = node.leftOrFirst;
+        }
+    }
+}
+
+void BVH::queryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& out) const {
+    if (m_nodes.empty()) return;
+
+    auto overlaps = [&](const glm::vec3& bMin, const glm::vec3& bMax) {
+        return bMin.x <= max.x && bMax.x >= min.x &&
+               bMin.y <= max.y && bMax.y >= min.y &&
+               bMin.z <= max.z && bMax.z >= min.z;
+    };
+
+    uint32_t stack[kMaxDepth];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (!overlaps(node.min, node.max)) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t index = m_indices[node.leftOrFirst + i];
+                if (overlaps(m_boxes[index].min, m_boxes[index].max)) {
+                    out.push_back(index);
+                }
+            }
+        } else {
+            stack[top++] = node.leftOrFirst + 1;
+            stack[top++] = node.leftOrFirst;
+        }
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,62 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "Raycast.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Bounding volume hierarchy over static boxes, built with a binned surface
+// area heuristic. Nodes sit in one flat array with siblings next to each
+// other, so a traversal step reads a single 32 byte node. Rebuild it when
+// the boxes change; it is meant for level geometry, not moving entities.
+class BVH {
+public:
+    BVH();
+
+    void build(const std::vector<AABB>& boxes);
+    void clear();
+
+    // Nearest box along the ray within maxDistance; hit.index is the
+    // box's position in the array passed to build()
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 RayHit& hit) const;
+    // Boxes overlapping the sphere / the box, as build() indices
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+    void queryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& out) const;
+
+    bool empty() const { return m_boxes.empty(); }
+    size_t getNodeCount() const { return m_nodes.size(); }
+    const AABB& getBox(size_t index) const { return m_boxes[index]; }
+    const std::vector<AABB>& getBoxes() const { return m_boxes; }
+
+private:
+    struct Node {
+        glm::vec3 min;
+        // Leaf: first entry in m_indices. Inner: index of the left child;
+        // the right child follows it.
+        uint32_t leftOrFirst;
+        glm::vec3 max;
+        // Number of boxes for a leaf, 0 for an inner node
+        uint32_t count;
+    };
+
+    void updateBounds(uint32_t nodeIndex);
+    void subdivide(uint32_t nodeIndex, int depth);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_indices;
+    std::vector<AABB> m_boxes;
+    std::vector<glm::vec3> m_centroids;
+};
+
+} // namespace Engine
+
+#endif // BVH_H
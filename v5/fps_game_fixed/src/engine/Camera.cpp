@@ -22,6 +22,10 @@ glm::mat4 Camera::getProjectionMatrix(float aspect) const {
     return glm::perspective(glm::radians(m_fov), aspect, 0.1f, 100.0f);
 }
 
+Frustum Camera::getFrustum(float aspect) const {
+    return Frustum::fromMatrix(getProjectionMatrix(aspect) * getViewMatrix());
+}
+
 void Camera::processKeyboard(CameraMovement direction, float deltaTime) {
     float velocity = m_movementSpeed * deltaTime;
     
@@ -0,0 +1,196 @@
+#include "CharacterController.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Engine {
+
+namespace {
+
+const float kSkin = 0.01f;
+// Surfaces facing up more steeply than this count as ground
+const float kGroundNormalY = 0.7f;
+
+struct Scratch {
+    std::vector<uint32_t> candidates;
+    AABBBatch boxes;
+};
+
+thread_local Scratch t_scratch;
+
+struct SweepState {
+    const AABBBatch* boxes;
+    const MoveBudget* budget;
+    MoveResult* result;
+};
+
+// Collide-and-slide from 'center' along 'delta'. Returns how far the
+// centre got; 'landed' reports a ground contact.
+glm::vec3 slide(SweepState& state, glm::vec3 center, glm::vec3 delta, bool& landed) {
+    const glm::vec3 original = delta;
+    landed = false;
+
+    for (;;) {
+        float length = glm::length(delta);
+        if (length < 1e-6f) break;
+
+        if (state.result->sweeps >= state.budget->maxSweeps) {
+            state.result->budgetExceeded = true;
+            break;
+        }
+        state.result->sweeps++;
+
+        glm::vec3 dir = delta / length;
+        RayHit hit;
+        if (!raycastBoxes(*state.boxes, center, dir, length + kSkin, hit)) {
+            center += delta;
+            break;
+        }
+
+        float travel = std::max(0.0f, hit.distance - kSkin);
+        center += dir * travel;
+
+        if (hit.normal.y > kGroundNormalY) {
+            landed = true;
+        } else if (hit.normal.y < -kGroundNormalY) {
+            state.result->hitCeiling = true;
+        } else {
+            state.result->hitWall = true;
+            state.result->wallNormal = hit.normal;
+        }
+
+        // Keep the part of the move that runs along the surface
+        glm::vec3 remaining = dir * (length - travel);
+        delta = remaining - hit.normal * glm::dot(remaining, hit.normal);
+
+        // Never slide back against the requested direction
+        if (glm::dot(delta, original) <= 0.0f) break;
+    }
+
+    return center;
+}
+
+// Pushes the centre out of any box it starts inside, along the shallowest axis
+glm::vec3 depenetrate(const AABBBatch& boxes, glm::vec3 center) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        glm::vec3 min = boxes.getMin(i);
+        glm::vec3 max = boxes.getMax(i);
+        if (center.x <= min.x || center.x >= max.x ||
+            center.y <= min.y || center.y >= max.y ||
+            center.z <= min.z || center.z >= max.z) {
+            continue;
+        }
+
+        int bestAxis = 0;
+        float bestPush = 0.0f;
+        float bestDepth = 1e30f;
+        for (int axis = 0; axis < 3; ++axis) {
+            float down = center[axis] - min[axis];
+            float up = max[axis] - center[axis];
+            if (down < bestDepth) { bestDepth = down; bestAxis = axis; bestPush = -(down + kSkin); }
+            if (up < bestDepth) { bestDepth = up; bestAxis = axis; bestPush = up + kSkin; }
+        }
+        center[bestAxis] += bestPush;
+    }
+    return center;
+}
+
+float horizontalDistance(const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 d = b - a;
+    return std::sqrt(d.x * d.x + d.z * d.z);
+}
+
+} // namespace
+
+CharacterController::CharacterController(const BVH& world, float floorHeight)
+    : m_world(world)
+    , m_floorHeight(floorHeight)
+{
+}
+
+MoveResult CharacterController::move(const glm::vec3& feet, const glm::vec3& displacement,
+                                     const CharacterShape& shape, const MoveBudget& budget) const {
+    MoveResult result;
+    const float r = shape.radius;
+    const float length = std::max(0.0f, shape.height - 2.0f * r);
+
+    // Broadphase: level boxes near the capsule's whole swept path,
+    // including a possible step up or down
+    glm::vec3 start = feet;
+    glm::vec3 end = feet + displacement;
+    glm::vec3 reach(r + kSkin, shape.stepHeight + kSkin, r + kSkin);
+    glm::vec3 sweptMin(std::min(start.x, end.x), std::min(start.y, end.y), std::min(start.z, end.z));
+    glm::vec3 sweptMax(std::max(start.x, end.x), std::max(start.y, end.y), std::max(start.z, end.z));
+    sweptMax.y += shape.height;
+
+    Scratch& scratch = t_scratch;
+    scratch.candidates.clear();
+    m_world.queryAABB(sweptMin - reach, sweptMax + reach, scratch.candidates);
+
+    size_t count = scratch.candidates.size();
+    result.candidates = static_cast<int>(count);
+    if (count > static_cast<size_t>(budget.maxCandidates)) {
+        // Colliding against only some of the boxes could tunnel through
+        // the rest, so don't move at all
+        result.position = feet;
+        result.grounded = feet.y <= m_floorHeight + kSkin;
+        result.budgetExceeded = true;
+        return result;
+    }
+
+    // Minkowski-grow each box so the capsule becomes a point at its
+    // bottom sphere centre
+    scratch.boxes.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const AABB& box = m_world.getBox(scratch.candidates[i]);
+        scratch.boxes.add(box.min - glm::vec3(r, r + length, r), box.max + glm::vec3(r));
+    }
+
+    SweepState state = {&scratch.boxes, &budget, &result};
+    glm::vec3 center = depenetrate(scratch.boxes, feet + glm::vec3(0.0f, r, 0.0f));
+
+    // Horizontal part, climbing a step if a wall stops it
+    glm::vec3 horizontal(displacement.x, 0.0f, displacement.z);
+    bool landed = false;
+    glm::vec3 slid = slide(state, center, horizontal, landed);
+
+    if (result.hitWall && shape.stepHeight > 0.0f) {
+        MoveResult before = result;
+        bool ignored = false;
+        glm::vec3 up = slide(state, center, glm::vec3(0.0f, shape.stepHeight, 0.0f), ignored);
+        glm::vec3 across = slide(state, up, horizontal, ignored);
+        bool stepLanded = false;
+        glm::vec3 down = slide(state, across, glm::vec3(0.0f, -(up.y - center.y) - kSkin, 0.0f), stepLanded);
+        if (down.y - r <= m_floorHeight) {
+            down.y = m_floorHeight + r;
+            stepLanded = true;
+        }
+
+        bool progressed = horizontalDistance(center, down) > horizontalDistance(center, slid) + kSkin;
+        if (stepLanded && progressed && !result.budgetExceeded) {
+            slid = down;
+        } else {
+            // Keep the plain slide; only the sweep count carries over
+            int sweeps = result.sweeps;
+            bool exceeded = result.budgetExceeded;
+            result = before;
+            result.sweeps = sweeps;
+            result.budgetExceeded = exceeded;
+        }
+    }
+    center = slid;
+
+    // Vertical part: gravity, jumps and landing
+    center = slide(state, center, glm::vec3(0.0f, displacement.y, 0.0f), landed);
+    result.grounded = landed;
+
+    if (center.y - r < m_floorHeight) {
+        center.y = m_floorHeight + r;
+        result.grounded = true;
+    }
+
+    result.position = center - glm::vec3(0.0f, r, 0.0f);
+    return result;
+}
+
+} // namespace Engine
@@ -0,0 +1,61 @@
+#ifndef CHARACTER_CONTROLLER_H
+#define CHARACTER_CONTROLLER_H
+
+#include "BVH.h"
+#include "Raycast.h"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// Upright capsule, measured from the feet
+struct CharacterShape {
+    float radius = 0.4f;
+    float height = 1.8f;
+    // Ledges up to this high are climbed instead of blocking
+    float stepHeight = 0.4f;
+};
+
+// Hard limits on the work one move() may do, so a crowd of controllers has
+// a bounded worst case. When a limit is hit the move stops early at the
+// last safe position and reports budgetExceeded.
+struct MoveBudget {
+    // Sweeps per move, counting slide iterations and step-up attempts
+    int maxSweeps = 8;
+    // Level boxes considered per move; with more than this near the path
+    // the character stays where it is
+    int maxCandidates = 32;
+};
+
+struct MoveResult {
+    glm::vec3 position = glm::vec3(0.0f); // feet
+    bool grounded = false;
+    bool hitWall = false;
+    // Normal of the last wall hit, valid when hitWall is set
+    glm::vec3 wallNormal = glm::vec3(0.0f);
+    bool hitCeiling = false;
+    bool budgetExceeded = false;
+    int sweeps = 0;
+    int candidates = 0;
+};
+
+// Collide-and-slide movement for capsules against the level BVH and an
+// implicit floor plane. The capsule is swept as its bottom sphere centre
+// against boxes grown by the radius and stretched down by the capsule's
+// length, which is exact on faces and slightly square at box edges.
+// move() is const and uses thread-local scratch, so job workers can move
+// different characters at the same time.
+class CharacterController {
+public:
+    explicit CharacterController(const BVH& world, float floorHeight = 0.0f);
+
+    MoveResult move(const glm::vec3& feet, const glm::vec3& displacement,
+                    const CharacterShape& shape, const MoveBudget& budget = MoveBudget()) const;
+
+private:
+    const BVH& m_world;
+    float m_floorHeight;
+};
+
+} // namespace Engine
+
+#endif // CHARACTER_CONTROLLER_H
@@ -0,0 +1,43 @@
+#include "CpuFeatures.h"
+
+#if defined(ENGINE_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Engine {
+
+static CpuFeatures detectCpuFeatures() {
+    CpuFeatures features;
+
+#if defined(ENGINE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(ENGINE_X86_SIMD) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+
+    // AVX state must also be enabled by the OS
+    bool osAvx = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+    if (maxLeaf >= 7 && osAvx && fma) {
+        __cpuidex(info, 7, 0);
+        features.avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#endif
+
+    return features;
+}
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+} // namespace Engine
@@ -0,0 +1,31 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// x86 builds get SIMD kernels; everything else uses the scalar paths
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ENGINE_X86_SIMD 1
+#endif
+
+// Lets a single function use AVX2 without building the whole target with
+// -mavx2, so the binary still runs on older CPUs. MSVC needs no attribute.
+#if defined(ENGINE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define ENGINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define ENGINE_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define ENGINE_TARGET_AVX2
+#define ENGINE_TARGET_SSE2
+#endif
+
+namespace Engine {
+
+// Instruction sets the running CPU supports, detected once on first use
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+
+    static const CpuFeatures& get();
+};
+
+} // namespace Engine
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,251 @@
+#include "Frustum.h"
+#include "CpuFeatures.h"
+#include <cmath>
+
+#ifdef ENGINE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Engine {
+
+void SphereBatch::clear() {
+    m_x.clear(); m_y.clear(); m_z.clear(); m_radius.clear();
+}
+
+void SphereBatch::reserve(size_t count) {
+    m_x.reserve(count); m_y.reserve(count); m_z.reserve(count); m_radius.reserve(count);
+}
+
+void SphereBatch::add(const glm::vec3& center, float radius) {
+    m_x.push_back(center.x); m_y.push_back(center.y); m_z.push_back(center.z);
+    m_radius.push_back(radius);
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& m) {
+    // Rows of a column-major matrix
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; ++i) {
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+    }
+
+    Frustum frustum;
+    for (int i = 0; i < 3; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            frustum.planes[i * 2][c] = row[3][c] + row[i][c];
+            frustum.planes[i * 2 + 1][c] = row[3][c] - row[i][c];
+        }
+    }
+
+    for (glm::vec4& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = plane * (1.0f / length);
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& p : planes) {
+        if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+    // Test the corner furthest along each plane normal
+    for (const glm::vec4& p : planes) {
+        float x = p.x >= 0.0f ? max.x : min.x;
+        float y = p.y >= 0.0f ? max.y : min.y;
+        float z = p.z >= 0.0f ? max.z : min.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+// Per-plane pointers to the box corner arrays that face along the normal
+struct CornerArrays {
+    const float* x[Frustum::PLANE_COUNT];
+    const float* y[Frustum::PLANE_COUNT];
+    const float* z[Frustum::PLANE_COUNT];
+};
+
+CornerArrays positiveCorners(const Frustum& frustum, const AABBBatch& b) {
+    CornerArrays corners;
+    for (int i = 0; i < Frustum::PLANE_COUNT; ++i) {
+        const glm::vec4& p = frustum.planes[i];
+        corners.x[i] = p.x >= 0.0f ? b.maxX() : b.minX();
+        corners.y[i] = p.y >= 0.0f ? b.maxY() : b.minY();
+        corners.z[i] = p.z >= 0.0f ? b.maxZ() : b.minZ();
+    }
+    return corners;
+}
+
+// The cull kernels write indices branch-free into 'out', which has room
+// for every bound, and return how many they wrote
+
+size_t cullAABBRange(const Frustum& frustum, const CornerArrays& c, size_t begin, size_t end,
+                     uint32_t* out) {
+    size_t written = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (int k = 0; k < Frustum::PLANE_COUNT && inside; ++k) {
+            const glm::vec4& p = frustum.planes[k];
+            inside = p.x * c.x[k][i] + p.y * c.y[k][i] + p.z * c.z[k][i] + p.w >= 0.0f;
+        }
+        out[written] = static_cast<uint32_t>(i);
+        written += inside;
+    }
+    return written;
+}
+
+size_t cullSphereRange(const Frustum& frustum, const SphereBatch& s, size_t begin, size_t end,
+                       uint32_t* out) {
+    size_t written = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (int k = 0; k < Frustum::PLANE_COUNT && inside; ++k) {
+            const glm::vec4& p = frustum.planes[k];
+            inside = p.x * s.x()[i] + p.y * s.y()[i] + p.z * s.z()[i] + p.w >= -s.radius()[i];
+        }
+        out[written] = static_cast<uint32_t>(i);
+        written += inside;
+    }
+    return written;
+}
+
+#ifdef ENGINE_X86_SIMD
+inline size_t writeLanes(int mask, size_t base, uint32_t* out) {
+    size_t written = 0;
+    for (int lane = 0; lane < 8; ++lane) {
+        out[written] = static_cast<uint32_t>(base + lane);
+        written += (mask >> lane) & 1;
+    }
+    return written;
+}
+
+ENGINE_TARGET_AVX2
+size_t cullAABBsAVX2(const Frustum& frustum, const CornerArrays& c, size_t count,
+                     uint32_t* out, size_t& written) {
+    __m256 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT];
+    __m256 pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm256_set1_ps(frustum.planes[k].x);
+        py[k] = _mm256_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm256_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm256_set1_ps(frustum.planes[k].w);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m256 d = _mm256_add_ps(
+                _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], _mm256_loadu_ps(c.x[k] + i)),
+                                            _mm256_mul_ps(py[k], _mm256_loadu_ps(c.y[k] + i))),
+                              _mm256_mul_ps(pz[k], _mm256_loadu_ps(c.z[k] + i))),
+                pw[k]);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+        }
+        written += writeLanes(_mm256_movemask_ps(inside), i, out + written);
+    }
+    return i;
+}
+
+ENGINE_TARGET_AVX2
+size_t cullSpheresAVX2(const Frustum& frustum, const SphereBatch& s, size_t count,
+                       uint32_t* out, size_t& written) {
+    __m256 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT];
+    __m256 pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm256_set1_ps(frustum.planes[k].x);
+        py[k] = _mm256_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm256_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm256_set1_ps(frustum.planes[k].w);
+    }
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(s.x() + i);
+        __m256 y = _mm256_loadu_ps(s.y() + i);
+        __m256 z = _mm256_loadu_ps(s.z() + i);
+        __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(s.radius() + i), signBit);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m256 d = _mm256_add_ps(
+                _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], x), _mm256_mul_ps(py[k], y)),
+                              _mm256_mul_ps(pz[k], z)),
+                pw[k]);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+        }
+        written += writeLanes(_mm256_movemask_ps(inside), i, out + written);
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+void cullAABBsScalar(const Frustum& frustum, const AABBBatch& boxes, std::vector<uint32_t>& visible) {
+    visible.resize(boxes.size());
+    if (boxes.empty()) return;
+    visible.resize(cullAABBRange(frustum, positiveCorners(frustum, boxes), 0, boxes.size(), visible.data()));
+}
+
+void cullSpheresScalar(const Frustum& frustum, const SphereBatch& spheres, std::vector<uint32_t>& visible) {
+    visible.resize(spheres.size());
+    visible.resize(cullSphereRange(frustum, spheres, 0, spheres.size(), visible.data()));
+}
+
+void cullAABBs(const Frustum& frustum, const AABBBatch& boxes, std::vector<uint32_t>& visible) {
+    visible.resize(boxes.size());
+    if (boxes.empty()) return;
+
+    CornerArrays corners = positiveCorners(frustum, boxes);
+    size_t done = 0;
+    size_t written = 0;
+#ifdef ENGINE_X86_SIMD
+    if (CpuFeatures::get().avx2) {
+        done = cullAABBsAVX2(frustum, corners, boxes.size(), visible.data(), written);
+    }
+#endif
+    written += cullAABBRange(frustum, corners, done, boxes.size(), visible.data() + written);
+    visible.resize(written);
+}
+
+void cullSpheres(const Frustum& frustum, const SphereBatch& spheres, std::vector<uint32_t>& visible) {
+    visible.resize(spheres.size());
+    if (spheres.size() == 0) return;
+
+    size_t done = 0;
+    size_t written = 0;
+#ifdef ENGINE_X86_SIMD
+    if (CpuFeatures::get().avx2) {
+        done = cullSpheresAVX2(frustum, spheres, spheres.size(), visible.data(), written);
+    }
+#endif
+    written += cullSphereRange(frustum, spheres, done, spheres.size(), visible.data() + written);
+    visible.resize(written);
+}
+
+void cullInstances(const Frustum& frustum, const MeshInstance* instances, size_t count,
+                   AABBBatch& scratch, std::vector<uint32_t>& visible) {
+    scratch.clear();
+    scratch.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 half = instances[i].scale * 0.5f;
+        scratch.add(instances[i].position - half, instances[i].position + half);
+    }
+    cullAABBs(frustum, scratch, visible);
+}
+
+} // namespace Engine
@@ -0,0 +1,61 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "MeshInstance.h"
+#include "Raycast.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// Bounding spheres stored as four float arrays, for the 8-wide cull
+class SphereBatch {
+public:
+    void clear();
+    void reserve(size_t count);
+    void add(const glm::vec3& center, float radius);
+
+    size_t size() const { return m_x.size(); }
+
+    const float* x() const { return m_x.data(); }
+    const float* y() const { return m_y.data(); }
+    const float* z() const { return m_z.data(); }
+    const float* radius() const { return m_radius.data(); }
+
+private:
+    std::vector<float> m_x, m_y, m_z, m_radius;
+};
+
+// Six inward-facing planes (xyz = unit normal, w = distance), so a point p
+// is inside when dot(xyz, p) + w >= 0 for all of them
+struct Frustum {
+    enum { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+    glm::vec4 planes[PLANE_COUNT];
+
+    // Gribb/Hartmann extraction from projection * view
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+    bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const;
+};
+
+// Batched culls: 'visible' is overwritten with the ascending indices of
+// the bounds that touch the frustum. They use the AVX2 kernel when the CPU
+// has it; the *Scalar versions always run the plain loop. The two can only
+// disagree on bounds within rounding error of a plane.
+void cullAABBs(const Frustum& frustum, const AABBBatch& boxes, std::vector<uint32_t>& visible);
+void cullSpheres(const Frustum& frustum, const SphereBatch& spheres, std::vector<uint32_t>& visible);
+void cullAABBsScalar(const Frustum& frustum, const AABBBatch& boxes, std::vector<uint32_t>& visible);
+void cullSpheresScalar(const Frustum& frustum, const SphereBatch& spheres, std::vector<uint32_t>& visible);
+
+// Culls unit-cube instances (as drawn by Renderer::renderInstanced);
+// 'scratch' holds their boxes between calls
+void cullInstances(const Frustum& frustum, const MeshInstance* instances, size_t count,
+                   AABBBatch& scratch, std::vector<uint32_t>& visible);
+
+} // namespace Engine
+
+#endif // FRUSTUM_H
@@ -0,0 +1,204 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Engine {
+
+// File layout (all little-endian):
+//   "FPSR" u16 version u32 seed f32 fixedTimestepHz i32 waveSize
+//   per frame: f32 deltaTime, u16 eventCount, then per event a u8 type and
+//     KEY:        u16 code, u8 pressed
+//     MOUSE_MOVE: f32 dx, f32 dy
+static const char kMagic[4] = {'F', 'P', 'S', 'R'};
+static const uint16_t kVersion = 2;
+
+namespace {
+
+void putU8(std::vector<uint8_t>& out, uint8_t v) {
+    out.push_back(v);
+}
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    }
+}
+
+void putF32(std::vector<uint8_t>& out, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(out, bits);
+}
+
+bool getBytes(std::ifstream& in, uint8_t* data, size_t size) {
+    in.read(reinterpret_cast<char*>(data), size);
+    return static_cast<size_t>(in.gcount()) == size;
+}
+
+bool getU8(std::ifstream& in, uint8_t& v) {
+    return getBytes(in, &v, 1);
+}
+
+bool getU16(std::ifstream& in, uint16_t& v) {
+    uint8_t b[2];
+    if (!getBytes(in, b, 2)) return false;
+    v = static_cast<uint16_t>(b[0] | (b[1] << 8));
+    return true;
+}
+
+bool getU32(std::ifstream& in, uint32_t& v) {
+    uint8_t b[4];
+    if (!getBytes(in, b, 4)) return false;
+    v = static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+        (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    return true;
+}
+
+bool getF32(std::ifstream& in, float& v) {
+    uint32_t bits;
+    if (!getU32(in, bits)) return false;
+    std::memcpy(&v, &bits, sizeof(v));
+    return true;
+}
+
+} // namespace
+
+InputRecorder::InputRecorder() : m_frameCount(0) {
+}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const std::string& path, const RecordingHeader& header) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "Failed to open input recording for writing: " << path << std::endl;
+        return false;
+    }
+
+    m_buffer.clear();
+    for (char c : kMagic) {
+        putU8(m_buffer, static_cast<uint8_t>(c));
+    }
+    putU16(m_buffer, kVersion);
+    putU32(m_buffer, header.seed);
+    putF32(m_buffer, header.fixedTimestepHz);
+    putU32(m_buffer, static_cast<uint32_t>(header.waveSize));
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+
+    m_frameCount = 0;
+    return true;
+}
+
+void InputRecorder::writeFrame(float deltaTime, const std::vector<InputEvent>& events) {
+    if (!m_file.is_open()) return;
+
+    // SDL can't deliver anywhere near 64k events in one frame
+    size_t count = std::min<size_t>(events.size(), 0xFFFF);
+
+    m_buffer.clear();
+    putF32(m_buffer, deltaTime);
+    putU16(m_buffer, static_cast<uint16_t>(count));
+
+    for (size_t i = 0; i < count; ++i) {
+        const InputEvent& e = events[i];
+        putU8(m_buffer, e.type);
+        if (e.type == InputEvent::KEY) {
+            putU16(m_buffer, static_cast<uint16_t>(e.code));
+            putU8(m_buffer, e.pressed ? 1 : 0);
+        } else {
+            putF32(m_buffer, e.dx);
+            putF32(m_buffer, e.dy);
+        }
+    }
+
+    ++m_frameCount;
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+}
+
+void InputRecorder::close() {
+    if (m_file.is_open()) {
+        m_file.close();
+        std::cout << "Input recording closed (" << m_frameCount << " frames)" << std::endl;
+    }
+}
+
+InputPlayback::InputPlayback() : m_frameCount(0) {
+}
+
+bool InputPlayback::open(const std::string& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        std::cerr << "Failed to open input recording: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint16_t version = 0;
+    uint32_t waveSize = 0;
+    m_file.read(magic, 4);
+    if (m_file.gcount() != 4 || std::memcmp(magic, kMagic, 4) != 0 ||
+        !getU16(m_file, version)) {
+        std::cerr << "Not a valid input recording: " << path << std::endl;
+        m_file.close();
+        return false;
+    }
+    // Version 1 didn't store the wave size, so it can't be replayed faithfully
+    if (version != kVersion) {
+        std::cerr << "Input recording " << path << " has unsupported version " << version
+                  << " (expected " << kVersion << "); record it again" << std::endl;
+        m_file.close();
+        return false;
+    }
+    if (!getU32(m_file, m_header.seed) || !getF32(m_file, m_header.fixedTimestepHz) ||
+        !getU32(m_file, waveSize)) {
+        std::cerr << "Not a valid input recording: " << path << std::endl;
+        m_file.close();
+        return false;
+    }
+    m_header.waveSize = static_cast<int32_t>(waveSize);
+
+    m_frameCount = 0;
+    return true;
+}
+
+bool InputPlayback::readFrame(float& deltaTime, std::vector<InputEvent>& events) {
+    events.clear();
+    if (!m_file.is_open()) return false;
+
+    uint16_t count = 0;
+    if (!getF32(m_file, deltaTime) || !getU16(m_file, count)) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < count; ++i) {
+        uint8_t type = 0;
+        if (!getU8(m_file, type)) return false;
+
+        if (type == InputEvent::KEY) {
+            uint16_t code = 0;
+            uint8_t pressed = 0;
+            if (!getU16(m_file, code) || !getU8(m_file, pressed)) return false;
+            events.push_back(InputEvent::key(code, pressed != 0));
+        } else if (type == InputEvent::MOUSE_MOVE) {
+            float dx = 0.0f, dy = 0.0f;
+            if (!getF32(m_file, dx) || !getF32(m_file, dy)) return false;
+            events.push_back(InputEvent::mouseMove(dx, dy));
+        } else {
+            std::cerr << "Corrupt input recording at frame " << m_frameCount << std::endl;
+            return false;
+        }
+    }
+
+    ++m_frameCount;
+    return true;
+}
+
+} // namespace Engine
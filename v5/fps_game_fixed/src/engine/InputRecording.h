@@ -0,0 +1,74 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+struct InputEvent {
+    enum Type : uint8_t {
+        KEY = 0,
+        MOUSE_MOVE = 1
+    };
+
+    Type type;
+    int code;       // KEY: Engine::Key code
+    bool pressed;   // KEY: down/up
+    float dx, dy;   // MOUSE_MOVE: relative motion
+
+    static InputEvent key(int code, bool pressed) { return {KEY, code, pressed, 0.0f, 0.0f}; }
+    static InputEvent mouseMove(float dx, float dy) { return {MOUSE_MOVE, 0, false, dx, dy}; }
+};
+
+// Header stored at the start of every recording: everything besides the
+// input that decides how a session plays out. Replaying with the same
+// values reproduces the recorded session frame for frame.
+struct RecordingHeader {
+    uint32_t seed = 0;
+    float fixedTimestepHz = 0.0f;
+    int32_t waveSize = 0; // enemies per wave, 0 for the normal ramp
+};
+
+// Writes one record per frame: the frame's delta time followed by the
+// input events that were delivered during it.
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const std::string& path, const RecordingHeader& header);
+    void writeFrame(float deltaTime, const std::vector<InputEvent>& events);
+    void close();
+
+    bool isOpen() const { return m_file.is_open(); }
+    uint32_t getFrameCount() const { return m_frameCount; }
+
+private:
+    std::ofstream m_file;
+    std::vector<uint8_t> m_buffer;
+    uint32_t m_frameCount;
+};
+
+class InputPlayback {
+public:
+    InputPlayback();
+
+    bool open(const std::string& path);
+    // Returns false once the recording is exhausted
+    bool readFrame(float& deltaTime, std::vector<InputEvent>& events);
+
+    const RecordingHeader& getHeader() const { return m_header; }
+    uint32_t getFrameCount() const { return m_frameCount; }
+
+private:
+    std::ifstream m_file;
+    RecordingHeader m_header;
+    uint32_t m_frameCount;
+};
+
+} // namespace Engine
+
+#endif // INPUT_RECORDING_H
@@ -0,0 +1,189 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace Engine {
+
+// Index of the queue owned by the current thread: 0 (injection queue) for
+// threads outside the pool
+static thread_local unsigned t_queueIndex = 0;
+static thread_local const JobSystem* t_owner = nullptr;
+
+JobSystem::JobSystem(int workerCount)
+    : m_queued(0)
+    , m_quit(false)
+{
+    if (workerCount < 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? static_cast<int>(hardware) - 1 : 0;
+    }
+
+    m_queues.push_back(std::make_unique<Queue>());
+    for (int i = 0; i < workerCount; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, static_cast<unsigned>(i + 1));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter* signal, JobCounter* dependsOn) {
+    if (signal) {
+        signal->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependsOn) {
+        std::lock_guard<std::mutex> lock(dependsOn->m_mutex);
+        if (!dependsOn->isDone()) {
+            // Re-submitted by whichever job drains the dependency
+            dependsOn->m_continuations.push_back([this, job, signal]() mutable {
+                push({std::move(job), signal});
+            });
+            return;
+        }
+    }
+
+    push({std::move(job), signal});
+}
+
+void JobSystem::push(Job job) {
+    if (m_threads.empty()) {
+        execute(job);
+        return;
+    }
+
+    unsigned index = (t_owner == this) ? t_queueIndex : 0;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->jobs.push_back(std::move(job));
+    }
+
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        // Taking the lock orders this with a worker about to go to sleep
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last job drops the count while holding the counter's mutex; wait
+    // for it to let go so the caller can safely destroy the counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain,
+                            const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    if (m_threads.empty() || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    // Queue all but the first chunk and run that one here
+    JobCounter counter;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        size_t end = std::min(begin + grain, count);
+        submit([&fn, begin, end]() { fn(begin, end); }, &counter);
+    }
+
+    fn(0, grain);
+    wait(counter);
+}
+
+bool JobSystem::tryRunOne() {
+    Job job;
+    if (!popOrSteal(job)) return false;
+
+    execute(job);
+    return true;
+}
+
+bool JobSystem::popOrSteal(Job& job) {
+    unsigned self = (t_owner == this) ? t_queueIndex : 0;
+    const unsigned queueCount = static_cast<unsigned>(m_queues.size());
+
+    // Own queue first, newest job (still warm in cache)
+    {
+        Queue& own = *m_queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then steal the oldest job from everyone else, starting past ourselves
+    for (unsigned i = 1; i < queueCount; ++i) {
+        Queue& victim = *m_queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    job.fn();
+
+    JobCounter* signal = job.signal;
+    if (!signal) return;
+
+    // Lock before the decrement so a concurrent submit(dependsOn) either
+    // sees the counter drained or gets its continuation run here
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(signal->m_mutex);
+        if (signal->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(signal->m_continuations);
+        }
+    }
+
+    for (auto& continuation : continuations) {
+        continuation();
+    }
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    t_queueIndex = index;
+    t_owner = this;
+
+    while (!m_quit.load(std::memory_order_acquire)) {
+        if (tryRunOne()) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] {
+            return m_quit.load(std::memory_order_acquire) ||
+                   m_queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,93 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+
+class JobSystem;
+
+// Counts outstanding jobs. Jobs submitted with a counter bump it and drop
+// it when they finish; jobs can also be held back until a counter drains.
+class JobCounter {
+public:
+    JobCounter() : m_pending(0) {}
+
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> m_pending;
+    std::mutex m_mutex;
+    std::vector<std::function<void()>> m_continuations;
+};
+
+// Work-stealing job system. Every worker owns a deque: it pushes and pops
+// its own jobs at the back and steals from the front of the others'.
+// Threads outside the pool submit through a shared injection queue and
+// help run jobs while they wait.
+class JobSystem {
+public:
+    // workerCount < 0 starts one worker per additional hardware thread;
+    // 0 runs every job inline on the submitting thread, which makes
+    // benchmark runs reproducible.
+    explicit JobSystem(int workerCount = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queue a job. 'signal' is decremented when it finishes; the job won't
+    // start until 'dependsOn' has drained.
+    void submit(std::function<void()> job, JobCounter* signal = nullptr,
+                JobCounter* dependsOn = nullptr);
+
+    // Block until the counter drains, running other jobs meanwhile
+    void wait(JobCounter& counter);
+
+    // Call fn(begin, end) over [0, count) in chunks of at most 'grain'
+    // items and return once all chunks are done
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& fn);
+
+    unsigned getWorkerCount() const { return static_cast<unsigned>(m_threads.size()); }
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        JobCounter* signal;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void push(Job job);
+    bool tryRunOne();
+    bool popOrSteal(Job& job);
+    void execute(Job& job);
+    void workerLoop(unsigned index);
+
+    // m_queues[0] is the injection queue; worker i owns m_queues[i + 1]
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued;
+    std::atomic<bool> m_quit;
+};
+
+} // namespace Engine
+
+#endif // JOB_SYSTEM_H
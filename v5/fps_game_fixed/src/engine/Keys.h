@@ -0,0 +1,27 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+namespace Engine {
+
+// Key codes passed to Window key callbacks. The values match SDL scancodes
+// so Window can forward them unchanged, but game code doesn't need SDL
+// headers to use them (the headless build has no SDL at all).
+namespace Key {
+    enum : int {
+        A      = 4,
+        D      = 7,
+        R      = 21,
+        S      = 22,
+        W      = 26,
+        ESCAPE = 41,
+        SPACE  = 44,
+        LSHIFT = 225,
+
+        // Not a scancode: Window reports the left mouse button as this key
+        MOUSE_LEFT = 1000
+    };
+}
+
+} // namespace Engine
+
+#endif // KEYS_H
@@ -1,5 +1,9 @@
 #include "Mesh.h"
+#include "MeshInstance.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -7,15 +11,194 @@
 
 namespace Engine {
 
-Mesh::Mesh() : m_VAO(0), m_VBO(0), m_EBO(0), m_indexCount(0), m_initialized(false) {
+namespace {
+
+// Largest position rounding error the PACKED layout may introduce, and
+// the UV range where half floats still resolve ~1/1000
+const float kMaxPositionError = 0.002f;
+const float kMaxHalfTexCoord = 2.0f;
+
+struct PackedVertex {
+    int16_t position[4]; // xyz, w is padding
+    uint16_t texCoords[2];
+    int16_t normal[2];
+    uint8_t color[4];
+};
+
+struct FullVertex {
+    float position[3];
+    float texCoords[2];
+    int16_t normal[2];
+    uint8_t color[4];
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+static_assert(sizeof(FullVertex) == 28, "FullVertex must stay tightly packed");
+
+int16_t toSnorm16(float value) {
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+uint8_t toUnorm8(float value) {
+    value = std::max(0.0f, std::min(1.0f, value));
+    return static_cast<uint8_t>(std::lround(value * 255.0f));
+}
+
+// Round-to-nearest; values below the smallest normal half flush to zero
+uint16_t toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent <= 0) return sign;
+    if (exponent >= 31) return sign | 0x7C00;
+    uint16_t half = static_cast<uint16_t>(sign | (exponent << 10) | (mantissa >> 13));
+    // A carry out of the mantissa correctly bumps the exponent
+    if (mantissa & 0x1000) ++half;
+    return half;
+}
+
+// Folds the unit sphere onto the [-1, 1] square
+void encodeNormal(const glm::vec3& n, int16_t out[2]) {
+    float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    float x = sum > 0.0f ? n.x / sum : 0.0f;
+    float y = sum > 0.0f ? n.y / sum : 0.0f;
+    if (n.z < 0.0f) {
+        float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    out[0] = toSnorm16(x);
+    out[1] = toSnorm16(y);
+}
+
+void encodeColor(const glm::vec3& color, uint8_t out[4]) {
+    out[0] = toUnorm8(color.x);
+    out[1] = toUnorm8(color.y);
+    out[2] = toUnorm8(color.z);
+    out[3] = 255;
+}
+
+} // namespace
+
+Mesh::Mesh()
+    : m_VAO(0), m_VBO(0), m_EBO(0), m_instanceBuffer(0), m_instanceFirst(0), m_indexCount(0)
+    , m_indexType(GL_UNSIGNED_INT), m_layout(VertexLayout::FULL)
+    , m_positionScale(1.0f), m_positionBias(0.0f), m_gpuBytes(0), m_id(0), m_initialized(false) {
 }
 
 Mesh::~Mesh() {
     cleanup();
 }
 
+Mesh::Mesh(Mesh&& other) noexcept
+    : m_VAO(other.m_VAO)
+    , m_VBO(other.m_VBO)
+    , m_EBO(other.m_EBO)
+    , m_instanceBuffer(other.m_instanceBuffer)
+    , m_instanceFirst(other.m_instanceFirst)
+    , m_indexCount(other.m_indexCount)
+    , m_indexType(other.m_indexType)
+    , m_layout(other.m_layout)
+    , m_positionScale(other.m_positionScale)
+    , m_positionBias(other.m_positionBias)
+    , m_gpuBytes(other.m_gpuBytes)
+    , m_id(other.m_id)
+    , m_initialized(other.m_initialized)
+{
+    other.m_initialized = false;
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+        m_VAO = other.m_VAO;
+        m_VBO = other.m_VBO;
+        m_EBO = other.m_EBO;
+        m_instanceBuffer = other.m_instanceBuffer;
+        m_instanceFirst = other.m_instanceFirst;
+        m_indexCount = other.m_indexCount;
+        m_indexType = other.m_indexType;
+        m_layout = other.m_layout;
+        m_positionScale = other.m_positionScale;
+        m_positionBias = other.m_positionBias;
+        m_gpuBytes = other.m_gpuBytes;
+        m_id = other.m_id;
+        m_initialized = other.m_initialized;
+        other.m_initialized = false;
+    }
+    return *this;
+}
+
 void Mesh::setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+    static std::atomic<uint32_t> nextId(1);
+    m_id = nextId++;
     m_indexCount = indices.size();
+    m_instanceBuffer = 0;
+    m_instanceFirst = 0;
+
+    // Positions quantize to the mesh's bounding box
+    glm::vec3 lo(0.0f), hi(0.0f);
+    float texCoordRange = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        for (int axis = 0; axis < 3; ++axis) {
+            lo[axis] = i == 0 ? v.position[axis] : std::min(lo[axis], v.position[axis]);
+            hi[axis] = i == 0 ? v.position[axis] : std::max(hi[axis], v.position[axis]);
+        }
+        texCoordRange = std::max(texCoordRange, std::max(std::fabs(v.texCoords.x), std::fabs(v.texCoords.y)));
+    }
+    glm::vec3 extent = (hi - lo) * 0.5f;
+    float largest = std::max(extent.x, std::max(extent.y, extent.z));
+    // snorm16 rounds to within half a step of 1/32767 of the extent
+    bool packed = largest * 0.5f / 32767.0f <= kMaxPositionError && texCoordRange <= kMaxHalfTexCoord;
+
+    std::vector<uint8_t> vertexData;
+    GLsizei stride;
+    if (packed) {
+        m_layout = VertexLayout::PACKED;
+        m_positionBias = (lo + hi) * 0.5f;
+        for (int axis = 0; axis < 3; ++axis) {
+            // Flat axes still need a non-zero scale to divide by
+            m_positionScale[axis] = extent[axis] > 0.0f ? extent[axis] : 1.0f;
+        }
+
+        stride = sizeof(PackedVertex);
+        vertexData.resize(vertices.size() * sizeof(PackedVertex));
+        PackedVertex* out = reinterpret_cast<PackedVertex*>(vertexData.data());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex& v = vertices[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                out[i].position[axis] = toSnorm16((v.position[axis] - m_positionBias[axis]) / m_positionScale[axis]);
+            }
+            out[i].position[3] = 0;
+            out[i].texCoords[0] = toHalf(v.texCoords.x);
+            out[i].texCoords[1] = toHalf(v.texCoords.y);
+            encodeNormal(v.normal, out[i].normal);
+            encodeColor(v.color, out[i].color);
+        }
+    } else {
+        m_layout = VertexLayout::FULL;
+        m_positionBias = glm::vec3(0.0f);
+        m_positionScale = glm::vec3(1.0f);
+
+        stride = sizeof(FullVertex);
+        vertexData.resize(vertices.size() * sizeof(FullVertex));
+        FullVertex* out = reinterpret_cast<FullVertex*>(vertexData.data());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex& v = vertices[i];
+            out[i].position[0] = v.position.x;
+            out[i].position[1] = v.position.y;
+            out[i].position[2] = v.position.z;
+            out[i].texCoords[0] = v.texCoords.x;
+            out[i].texCoords[1] = v.texCoords.y;
+            encodeNormal(v.normal, out[i].normal);
+            encodeColor(v.color, out[i].color);
+        }
+    }
 
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
@@ -24,36 +207,98 @@ void Mesh::setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsi
     glBindVertexArray(m_VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size(), vertexData.data(), GL_STATIC_DRAW);
 
+    // Index 65535 is still usable; no primitive restart is enabled
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    size_t indexBytes;
+    if (vertices.size() <= 65536) {
+        std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+        m_indexType = GL_UNSIGNED_SHORT;
+        indexBytes = shortIndices.size() * sizeof(uint16_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, shortIndices.data(), GL_STATIC_DRAW);
+    } else {
+        m_indexType = GL_UNSIGNED_INT;
+        indexBytes = indices.size() * sizeof(unsigned int);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices.data(), GL_STATIC_DRAW);
+    }
+    m_gpuBytes = vertexData.size() + indexBytes;
 
     // Position
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    if (packed) {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertex, position));
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(FullVertex, position));
+    }
 
-    // Normal
+    // Normal (octahedral)
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride,
+                          packed ? (void*)offsetof(PackedVertex, normal) : (void*)offsetof(FullVertex, normal));
 
     // TexCoords
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    if (packed) {
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, texCoords));
+    } else {
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(FullVertex, texCoords));
+    }
 
     // Color
     glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glVertexAttribPointer(3, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          packed ? (void*)offsetof(PackedVertex, color) : (void*)offsetof(FullVertex, color));
 
     glBindVertexArray(0);
     m_initialized = true;
 }
 
+void Mesh::setDecodeAttributes() const {
+    // Attributes 7 and 8 have no array enabled, so every vertex reads
+    // these current values
+    glVertexAttrib3f(7, m_positionScale.x, m_positionScale.y, m_positionScale.z);
+    glVertexAttrib3f(8, m_positionBias.x, m_positionBias.y, m_positionBias.z);
+}
+
 void Mesh::draw() {
     if (!m_initialized) return;
     
     glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+    setDecodeAttributes();
+    glDrawElements(GL_TRIANGLES, m_indexCount, m_indexType, 0);
+    glBindVertexArray(0);
+}
+
+void Mesh::drawInstanced(GLuint instanceBuffer, size_t first, GLsizei count) {
+    if (!m_initialized || count <= 0) return;
+    
+    glBindVertexArray(m_VAO);
+    setDecodeAttributes();
+    
+    // The VAO remembers the instance attributes, so this only runs when
+    // the mesh's batch moved within the buffer or the buffer changed
+    if (m_instanceBuffer != instanceBuffer || m_instanceFirst != first) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        size_t base = first * sizeof(MeshInstance);
+        
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(MeshInstance), (void*)(base + offsetof(MeshInstance, position)));
+        glVertexAttribDivisor(4, 1);
+        
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(MeshInstance), (void*)(base + offsetof(MeshInstance, scale)));
+        glVertexAttribDivisor(5, 1);
+        
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(MeshInstance), (void*)(base + offsetof(MeshInstance, color)));
+        glVertexAttribDivisor(6, 1);
+        
+        m_instanceBuffer = instanceBuffer;
+        m_instanceFirst = first;
+    }
+    
+    glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, m_indexType, 0, count);
     glBindVertexArray(0);
 }
 
@@ -66,8 +311,8 @@ void Mesh::cleanup() {
     }
 }
 
-Mesh Mesh::createCube(const glm::vec3& color) {
-    std::vector<Vertex> vertices = {
+void Mesh::buildCube(const glm::vec3& color, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    vertices = {
         // Front face
         {{-0.5f, -0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}, color},
         {{ 0.5f, -0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}, color},
@@ -105,7 +350,7 @@ Mesh Mesh::createCube(const glm::vec3& color) {
         {{-0.5f,  0.5f, -0.5f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}, color}
     };
 
-    std::vector<unsigned int> indices = {
+    indices = {
         0, 1, 2, 2, 3, 0,       // Front
         4, 5, 6, 6, 7, 4,       // Back
         8, 9, 10, 10, 11, 8,    // Top
@@ -113,33 +358,72 @@ Mesh Mesh::createCube(const glm::vec3& color) {
         16, 17, 18, 18, 19, 16, // Right
         20, 21, 22, 22, 23, 20  // Left
     };
-
-    Mesh mesh;
-    mesh.setupMesh(vertices, indices);
-    return mesh;
 }
 
-Mesh Mesh::createPlane(float size, const glm::vec3& color) {
+void Mesh::buildPlane(float size, const glm::vec3& color, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
     float half = size * 0.5f;
     
-    std::vector<Vertex> vertices = {
+    vertices = {
         {{-half, 0.0f, -half}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}, color},
         {{ half, 0.0f, -half}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}, color},
         {{ half, 0.0f,  half}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}, color},
         {{-half, 0.0f,  half}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}, color}
     };
 
-    std::vector<unsigned int> indices = {0, 1, 2, 2, 3, 0};
+    indices = {0, 1, 2, 2, 3, 0};
+}
+
+Mesh Mesh::createCube(const glm::vec3& color) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    buildCube(color, vertices, indices);
 
     Mesh mesh;
     mesh.setupMesh(vertices, indices);
     return mesh;
 }
 
+Mesh Mesh::createPlane(float size, const glm::vec3& color) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    buildPlane(size, color, vertices, indices);
+
+    Mesh mesh;
+    mesh.setupMesh(vertices, indices);
+    return mesh;
+}
+
+void Mesh::appendTransformed(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                             const std::vector<Vertex>& srcVertices, const std::vector<unsigned int>& srcIndices,
+                             const glm::vec3& position, const glm::vec3& scale, const glm::vec3& tint) {
+    unsigned int base = static_cast<unsigned int>(vertices.size());
+    for (const Vertex& src : srcVertices) {
+        Vertex v = src;
+        v.position = src.position * scale + position;
+        // Inverse-transpose of a pure scale
+        v.normal = glm::normalize(glm::vec3(src.normal.x / scale.x,
+                                            src.normal.y / scale.y,
+                                            src.normal.z / scale.z));
+        v.color = src.color * tint;
+        vertices.push_back(v);
+    }
+    for (unsigned int index : srcIndices) {
+        indices.push_back(base + index);
+    }
+}
+
 Mesh Mesh::createSphere(float radius, int segments, const glm::vec3& color) {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    buildSphere(radius, segments, color, vertices, indices);
+
+    Mesh mesh;
+    mesh.setupMesh(vertices, indices);
+    return mesh;
+}
 
+void Mesh::buildSphere(float radius, int segments, const glm::vec3& color,
+                       std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
     for (int lat = 0; lat <= segments; ++lat) {
         float theta = lat * M_PI / segments;
         float sinTheta = sin(theta);
@@ -173,10 +457,6 @@ Mesh Mesh::createSphere(float radius, int segments, const glm::vec3& color) {
             indices.push_back(first + 1);
         }
     }
-
-    Mesh mesh;
-    mesh.setupMesh(vertices, indices);
-    return mesh;
 }
 
 } // namespace Engine
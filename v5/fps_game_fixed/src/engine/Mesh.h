@@ -3,6 +3,8 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace Engine {
@@ -14,22 +16,71 @@ struct Vertex {
     glm::vec3 color;
 };
 
+// GPU vertex formats; Vertex is only the CPU-side authoring format.
+// Both store octahedral snorm16 normals and unorm8 colors.
+enum class VertexLayout {
+    PACKED, // 20 bytes: snorm16 position rescaled per mesh, half-float UVs
+    FULL    // 28 bytes: float position and UVs, for meshes too large to quantize
+};
+
 class Mesh {
 public:
     Mesh();
     ~Mesh();
 
+    // Meshes own GL objects, so they move but never copy
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Uploads with the PACKED layout when quantizing keeps positions within
+    // 2 mm and UVs within half-float range, and 16-bit indices when there
+    // are few enough vertices
     void setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
     void draw();
+    // Draws 'count' copies, reading MeshInstance records from instanceBuffer
+    // starting at record 'first'
+    void drawInstanced(GLuint instanceBuffer, size_t first, GLsizei count);
     void cleanup();
 
+    // Unique per setupMesh() call; render queues sort on it
+    uint32_t getId() const { return m_id; }
+    unsigned int getTriangleCount() const { return m_indexCount / 3; }
+    VertexLayout getLayout() const { return m_layout; }
+    GLenum getIndexType() const { return m_indexType; }
+    // Vertex plus index buffer size
+    size_t getGpuBytes() const { return m_gpuBytes; }
+
     static Mesh createCube(const glm::vec3& color = glm::vec3(1.0f));
     static Mesh createPlane(float size, const glm::vec3& color = glm::vec3(1.0f));
     static Mesh createSphere(float radius, int segments, const glm::vec3& color = glm::vec3(1.0f));
 
+    // CPU-side geometry behind the create* functions, for baking
+    static void buildCube(const glm::vec3& color, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    static void buildPlane(float size, const glm::vec3& color, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    static void buildSphere(float radius, int segments, const glm::vec3& color,
+                            std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    // Appends a scaled, translated and color-tinted copy of src, with its
+    // indices rebased, so many static objects can share one buffer
+    static void appendTransformed(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                                  const std::vector<Vertex>& srcVertices, const std::vector<unsigned int>& srcIndices,
+                                  const glm::vec3& position, const glm::vec3& scale, const glm::vec3& tint);
+
 private:
+    // Feeds the shaders' aPosScale/aPosBias constant attributes
+    void setDecodeAttributes() const;
+
     GLuint m_VAO, m_VBO, m_EBO;
+    GLuint m_instanceBuffer; // instance buffer the VAO's attributes 4-6 read from
+    size_t m_instanceFirst;  // and the record they start at
     unsigned int m_indexCount;
+    GLenum m_indexType;
+    VertexLayout m_layout;
+    glm::vec3 m_positionScale;
+    glm::vec3 m_positionBias;
+    size_t m_gpuBytes;
+    uint32_t m_id;
     bool m_initialized;
 };
 
@@ -0,0 +1,90 @@
+#include "MeshCache.h"
+#include <algorithm>
+#include <tuple>
+
+namespace Engine {
+
+bool MeshCache::Key::operator<(const Key& other) const {
+    return std::tie(shape, size, segments, r, g, b) <
+           std::tie(other.shape, other.size, other.segments, other.r, other.g, other.b);
+}
+
+MeshCache::MeshCache() : m_created(0), m_reused(0) {
+}
+
+MeshCache::~MeshCache() {
+    clear();
+}
+
+template <typename Create>
+MeshHandle MeshCache::get(const Key& key, Create create) {
+    auto it = m_meshes.find(key);
+    if (it != m_meshes.end()) {
+        m_reused++;
+        return it->second;
+    }
+
+    MeshHandle mesh = std::make_shared<Mesh>(create());
+    m_meshes.emplace(key, mesh);
+    m_created++;
+    return mesh;
+}
+
+MeshHandle MeshCache::getCube(const glm::vec3& color) {
+    Key key = {Shape::CUBE, 0.0f, 0, color.x, color.y, color.z};
+    return get(key, [&]() { return Mesh::createCube(color); });
+}
+
+MeshHandle MeshCache::getPlane(float size, const glm::vec3& color) {
+    Key key = {Shape::PLANE, size, 0, color.x, color.y, color.z};
+    return get(key, [&]() { return Mesh::createPlane(size, color); });
+}
+
+MeshHandle MeshCache::getSphere(float radius, int segments, const glm::vec3& color) {
+    Key key = {Shape::SPHERE, radius, segments, color.x, color.y, color.z};
+    return get(key, [&]() { return Mesh::createSphere(radius, segments, color); });
+}
+
+MeshHandle MeshCache::adopt(Mesh&& mesh) {
+    MeshHandle handle = std::make_shared<Mesh>(std::move(mesh));
+    m_adopted.push_back(handle);
+    m_created++;
+    return handle;
+}
+
+void MeshCache::releaseUnused() {
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        if (it->second.use_count() == 1) {
+            it = m_meshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_adopted.erase(std::remove_if(m_adopted.begin(), m_adopted.end(),
+                                   [](const MeshHandle& mesh) { return mesh.use_count() == 1; }),
+                    m_adopted.end());
+}
+
+size_t MeshCache::getGpuBytes() const {
+    size_t bytes = 0;
+    for (const auto& entry : m_meshes) {
+        bytes += entry.second->getGpuBytes();
+    }
+    for (const auto& mesh : m_adopted) {
+        bytes += mesh->getGpuBytes();
+    }
+    return bytes;
+}
+
+void MeshCache::clear() {
+    for (auto& entry : m_meshes) {
+        entry.second->cleanup();
+    }
+    m_meshes.clear();
+    for (auto& mesh : m_adopted) {
+        mesh->cleanup();
+    }
+    m_adopted.clear();
+}
+
+} // namespace Engine
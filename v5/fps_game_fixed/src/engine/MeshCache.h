@@ -0,0 +1,65 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Engine {
+
+// Shared, ref-counted mesh. Every holder of the same handle draws the same
+// GL buffers.
+using MeshHandle = std::shared_ptr<Mesh>;
+
+// Hands out one mesh per generator + parameter set, so callers asking for
+// the same cube share a single VAO/VBO/EBO instead of building their own.
+// Needs a current GL context; clear() must run before the context goes away.
+class MeshCache {
+public:
+    MeshCache();
+    ~MeshCache();
+
+    MeshHandle getCube(const glm::vec3& color = glm::vec3(1.0f));
+    MeshHandle getPlane(float size, const glm::vec3& color = glm::vec3(1.0f));
+    MeshHandle getSphere(float radius, int segments, const glm::vec3& color = glm::vec3(1.0f));
+    // Takes ownership of a one-off mesh (e.g. baked level geometry) so it
+    // is released with the rest; it is never shared through the lookups
+    MeshHandle adopt(Mesh&& mesh);
+
+    // Frees meshes nobody outside the cache holds any more
+    void releaseUnused();
+    // Frees every mesh's GL objects; outstanding handles stop drawing
+    void clear();
+
+    size_t getMeshCount() const { return m_meshes.size() + m_adopted.size(); }
+    size_t getCreatedCount() const { return m_created; }
+    size_t getReusedCount() const { return m_reused; }
+    // Vertex and index buffer bytes across every live mesh
+    size_t getGpuBytes() const;
+
+private:
+    enum class Shape { CUBE, PLANE, SPHERE };
+
+    struct Key {
+        Shape shape;
+        float size;
+        int segments;
+        float r, g, b;
+
+        bool operator<(const Key& other) const;
+    };
+
+    template <typename Create>
+    MeshHandle get(const Key& key, Create create);
+
+    std::map<Key, MeshHandle> m_meshes;
+    std::vector<MeshHandle> m_adopted;
+    size_t m_created;
+    size_t m_reused;
+};
+
+} // namespace Engine
+
+#endif // MESH_CACHE_H
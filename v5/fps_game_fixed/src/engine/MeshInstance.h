@@ -0,0 +1,18 @@
+#ifndef MESH_INSTANCE_H
+#define MESH_INSTANCE_H
+
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// One unrotated, scaled copy of a mesh. Also the per-instance vertex
+// layout of Renderer::renderInstanced, so arrays of these upload as-is.
+struct MeshInstance {
+    glm::vec3 position;
+    glm::vec3 scale;
+    glm::vec3 color;
+};
+
+} // namespace Engine
+
+#endif // MESH_INSTANCE_H
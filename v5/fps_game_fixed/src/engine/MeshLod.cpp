@@ -0,0 +1,55 @@
+#include "MeshLod.h"
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Engine {
+
+LodChain::LodChain()
+    : m_boundingRadius(0.0f)
+    , m_hysteresis(0.15f)
+{
+}
+
+void LodChain::addLevel(MeshHandle mesh, float maxScreenSize) {
+    unsigned int triangles = mesh->getTriangleCount();
+    m_levels.push_back({std::move(mesh), maxScreenSize, triangles});
+}
+
+int LodChain::select(float screenSize, int current) const {
+    int last = static_cast<int>(m_levels.size()) - 1;
+
+    // Keep the current level while the size is within the widened band
+    if (current >= 0 && current <= last) {
+        bool fitsCurrent = screenSize <= m_levels[current].maxScreenSize * (1.0f + m_hysteresis);
+        bool needsCurrent = current == last ||
+                            screenSize > m_levels[current + 1].maxScreenSize * (1.0f - m_hysteresis);
+        if (fitsCurrent && needsCurrent) return current;
+    }
+
+    // Otherwise the coarsest level allowed at this size
+    for (int level = last; level > 0; --level) {
+        if (screenSize <= m_levels[level].maxScreenSize) return level;
+    }
+    return 0;
+}
+
+LodChain LodChain::createSphere(MeshCache& meshes, float radius, const glm::vec3& color,
+                                const std::vector<int>& segments, float errorTolerance) {
+    LodChain chain;
+    chain.m_boundingRadius = radius;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        // A ring of n segments falls short of the circle by r * (1 - cos(pi / n))
+        float limit = std::numeric_limits<float>::max();
+        if (i > 0) {
+            limit = errorTolerance / (1.0f - std::cos(static_cast<float>(M_PI) / segments[i]));
+        }
+        chain.addLevel(meshes.getSphere(radius, segments[i], color), limit);
+    }
+    return chain;
+}
+
+} // namespace Engine
@@ -0,0 +1,60 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include "MeshCache.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Engine {
+
+// Tessellations of one shape, finest first. Each level has the largest
+// screen size it may be drawn at, where screen size is the bounding
+// radius projected to a fraction of the viewport height.
+class LodChain {
+public:
+    LodChain();
+
+    // Levels must be added finest first with shrinking maxScreenSize
+    void addLevel(MeshHandle mesh, float maxScreenSize);
+    // Sizes must pass a level's limit by this fraction before the choice
+    // changes, so objects hovering at a limit don't flip every frame
+    void setHysteresis(float fraction) { m_hysteresis = fraction; }
+
+    // Picks the level for 'screenSize' given the level drawn last frame
+    int select(float screenSize, int current) const;
+    // Bounding radius scaled by 'scale' at 'distance', as a fraction of the
+    // viewport height; 'projectionScale' is the projection's y scale
+    // (1 / tan(fovY / 2))
+    float getScreenSize(float scale, float distance, float projectionScale) const {
+        return m_boundingRadius * scale * projectionScale / (distance > 1e-3f ? distance : 1e-3f);
+    }
+
+    // Radius of the shape before instance scaling
+    float getBoundingRadius() const { return m_boundingRadius; }
+    size_t getLevelCount() const { return m_levels.size(); }
+    Mesh& getMesh(int level) const { return *m_levels[level].mesh; }
+    unsigned int getTriangleCount(int level) const { return m_levels[level].triangles; }
+    bool empty() const { return m_levels.empty(); }
+
+    // Spheres from the cache, one per segment count (finest first). A
+    // coarser level takes over once its silhouette is off by no more than
+    // errorTolerance of the viewport height.
+    static LodChain createSphere(MeshCache& meshes, float radius, const glm::vec3& color,
+                                 const std::vector<int>& segments = {24, 12, 6},
+                                 float errorTolerance = 0.002f);
+
+private:
+    struct Level {
+        MeshHandle mesh;
+        float maxScreenSize;
+        unsigned int triangles;
+    };
+
+    std::vector<Level> m_levels;
+    float m_boundingRadius;
+    float m_hysteresis;
+};
+
+} // namespace Engine
+
+#endif // MESH_LOD_H
@@ -0,0 +1,343 @@
+#include "OcclusionCuller.h"
+#include "CpuFeatures.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef ENGINE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Engine {
+
+namespace {
+
+// Points closer than this (clip w) are treated as behind the camera
+const float kMinW = 0.05f;
+const int kBandRows = 16;
+
+int roundUpPow2(int value, int minimum) {
+    int result = minimum;
+    while (result < value) result *= 2;
+    return result;
+}
+
+// Box corner i has bit 0/1/2 set for max x/y/z
+glm::vec3 corner(const AABB& box, int i) {
+    return glm::vec3((i & 1) ? box.max.x : box.min.x,
+                     (i & 2) ? box.max.y : box.min.y,
+                     (i & 4) ? box.max.z : box.min.z);
+}
+
+// Faces as corner quads
+const int kFaces[6][4] = {
+    {0, 2, 6, 4}, {1, 3, 7, 5}, // -x, +x
+    {0, 1, 5, 4}, {2, 3, 7, 6}, // -y, +y
+    {0, 1, 3, 2}, {4, 5, 7, 6}  // -z, +z
+};
+
+// Edge a->b as E(x, y) = dx * x + dy * y + c, positive inside a
+// counter-clockwise triangle. 'inner' is how far E must clear zero for a
+// whole pixel around (x, y) to be inside.
+struct Edge {
+    float dx, dy, c, inner;
+
+    Edge(float ax, float ay, float bx, float by)
+        : dx(-(by - ay))
+        , dy(bx - ax)
+        , c((by - ay) * ax - (bx - ax) * ay)
+        , inner(0.5f * (std::fabs(bx - ax) + std::fabs(by - ay)))
+    {
+    }
+};
+
+void rasterizeRowScalar(float* row, int x0, int x1, float py, const Edge* e,
+                        float zA, float zRow, float zMax) {
+    for (int x = x0; x <= x1; ++x) {
+        float px = x + 0.5f;
+        bool inside = true;
+        for (int k = 0; k < 3; ++k) {
+            inside = inside && e[k].dx * px + e[k].dy * py + e[k].c >= e[k].inner;
+        }
+        if (inside) {
+            float z = std::min(zA * px + zRow, zMax);
+            row[x] = std::min(row[x], z);
+        }
+    }
+}
+
+#ifdef ENGINE_X86_SIMD
+// Four pixels per step; x0 is a multiple of 4 and rows are padded to 4
+ENGINE_TARGET_SSE2
+void rasterizeRowSSE2(float* row, int x0, int x1, float py, const Edge* e,
+                      float zA, float zRow, float zMax) {
+    const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 edgeRow[3], edgeDx[3], inner[3];
+    for (int k = 0; k < 3; ++k) {
+        edgeRow[k] = _mm_set1_ps(e[k].dy * py + e[k].c);
+        edgeDx[k] = _mm_set1_ps(e[k].dx);
+        inner[k] = _mm_set1_ps(e[k].inner);
+    }
+    const __m128 za = _mm_set1_ps(zA);
+    const __m128 zr = _mm_set1_ps(zRow);
+    const __m128 zm = _mm_set1_ps(zMax);
+
+    for (int x = x0; x <= x1; x += 4) {
+        __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+        __m128 mask = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeDx[0], px), edgeRow[0]), inner[0]);
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeDx[1], px), edgeRow[1]), inner[1]));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeDx[2], px), edgeRow[2]), inner[2]));
+        if (_mm_movemask_ps(mask) == 0) continue;
+
+        __m128 z = _mm_min_ps(_mm_add_ps(_mm_mul_ps(za, px), zr), zm);
+        __m128 old = _mm_loadu_ps(row + x);
+        __m128 merged = _mm_min_ps(old, z);
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, merged), _mm_andnot_ps(mask, old)));
+    }
+}
+#endif
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+    : m_width(roundUpPow2(width, 8))
+    , m_height(roundUpPow2(height, 8))
+    , m_maxOccluders(64)
+    , m_ready(false)
+{
+    for (int w = m_width, h = m_height; w >= 1 && h >= 1; w /= 2, h /= 2) {
+        m_levels.emplace_back(static_cast<size_t>(w) * h, 1.0f);
+    }
+}
+
+bool OcclusionCuller::project(const glm::vec3& p, glm::vec3& screen) const {
+    return toScreen(m_viewProjection * glm::vec4(p, 1.0f), screen);
+}
+
+bool OcclusionCuller::toScreen(const glm::vec4& clip, glm::vec3& screen) const {
+    if (clip.w < kMinW) return false;
+    float inv = 1.0f / clip.w;
+    screen.x = (clip.x * inv * 0.5f + 0.5f) * m_width;
+    screen.y = (clip.y * inv * 0.5f + 0.5f) * m_height;
+    screen.z = clip.z * inv * 0.5f + 0.5f;
+    return true;
+}
+
+void OcclusionCuller::selectOccluders(const glm::vec3& eye, const std::vector<AABB>& occluders) {
+    // Rough projected size: face area over squared distance
+    m_selected.clear();
+    m_scores.resize(occluders.size());
+    for (size_t i = 0; i < occluders.size(); ++i) {
+        const AABB& box = occluders[i];
+        glm::vec3 size = box.max - box.min;
+        glm::vec3 toBox = (box.min + box.max) * 0.5f - eye;
+        float area = size.x * size.y + size.y * size.z + size.z * size.x;
+        m_scores[i] = area / std::max(glm::dot(toBox, toBox), 1.0f);
+        m_selected.push_back(static_cast<uint32_t>(i));
+    }
+
+    if (m_selected.size() > m_maxOccluders) {
+        std::nth_element(m_selected.begin(), m_selected.begin() + m_maxOccluders, m_selected.end(),
+            [this](uint32_t a, uint32_t b) { return m_scores[a] > m_scores[b]; });
+        m_selected.resize(m_maxOccluders);
+    }
+}
+
+void OcclusionCuller::addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    Triangle t;
+    t.x[0] = a.x; t.y[0] = a.y;
+    t.x[1] = b.x; t.y[1] = b.y;
+    t.x[2] = c.x; t.y[2] = c.y;
+    float z[3] = { a.z, b.z, c.z };
+
+    float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+    if (area < 0.0f) {
+        std::swap(t.x[1], t.x[2]);
+        std::swap(t.y[1], t.y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+    }
+    // Too thin to fully cover any pixel
+    if (area < 1e-6f) return;
+
+    float e1x = t.x[1] - t.x[0], e1y = t.y[1] - t.y[0], e1z = z[1] - z[0];
+    float e2x = t.x[2] - t.x[0], e2y = t.y[2] - t.y[0], e2z = z[2] - z[0];
+    t.zA = (e1z * e2y - e2z * e1y) / area;
+    t.zB = (e1x * e2z - e2x * e1z) / area;
+    // Farthest depth anywhere inside a pixel, not at its centre
+    t.zC = z[0] - t.zA * t.x[0] - t.zB * t.y[0] + 0.5f * (std::fabs(t.zA) + std::fabs(t.zB));
+    t.zMax = std::max(z[0], std::max(z[1], z[2]));
+
+    float minX = std::min(t.x[0], std::min(t.x[1], t.x[2]));
+    float maxX = std::max(t.x[0], std::max(t.x[1], t.x[2]));
+    float minY = std::min(t.y[0], std::min(t.y[1], t.y[2]));
+    float maxY = std::max(t.y[0], std::max(t.y[1], t.y[2]));
+    if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height) return;
+
+    t.minX = std::max(0, static_cast<int>(minX));
+    t.maxX = std::min(m_width - 1, static_cast<int>(maxX));
+    t.minY = std::max(0, static_cast<int>(minY));
+    t.maxY = std::min(m_height - 1, static_cast<int>(maxY));
+    m_triangles.push_back(t);
+}
+
+void OcclusionCuller::setupTriangles(const std::vector<AABB>& occluders) {
+    m_triangles.clear();
+    for (uint32_t index : m_selected) {
+        const AABB& box = occluders[index];
+
+        glm::vec3 screen[8];
+        bool valid[8];
+        for (int i = 0; i < 8; ++i) {
+            valid[i] = project(corner(box, i), screen[i]);
+        }
+
+        for (const auto& face : kFaces) {
+            // Triangles reaching behind the camera would need clipping;
+            // dropping them only costs some culling
+            if (!valid[face[0]] || !valid[face[1]] || !valid[face[2]] || !valid[face[3]]) continue;
+            addTriangle(screen[face[0]], screen[face[1]], screen[face[2]]);
+            addTriangle(screen[face[0]], screen[face[2]], screen[face[3]]);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeBand(int rowBegin, int rowEnd) {
+    std::vector<float>& depth = m_levels[0];
+    std::fill(depth.begin() + static_cast<size_t>(rowBegin) * m_width,
+              depth.begin() + static_cast<size_t>(rowEnd) * m_width, 1.0f);
+
+#ifdef ENGINE_X86_SIMD
+    const bool sse2 = CpuFeatures::get().sse2;
+#endif
+
+    for (const Triangle& t : m_triangles) {
+        int y0 = std::max(t.minY, rowBegin);
+        int y1 = std::min(t.maxY, rowEnd - 1);
+        if (y0 > y1) continue;
+
+        Edge edges[3] = {
+            Edge(t.x[0], t.y[0], t.x[1], t.y[1]),
+            Edge(t.x[1], t.y[1], t.x[2], t.y[2]),
+            Edge(t.x[2], t.y[2], t.x[0], t.y[0])
+        };
+
+        for (int y = y0; y <= y1; ++y) {
+            float py = y + 0.5f;
+            float zRow = t.zB * py + t.zC;
+            float* row = &depth[static_cast<size_t>(y) * m_width];
+#ifdef ENGINE_X86_SIMD
+            if (sse2) {
+                rasterizeRowSSE2(row, t.minX & ~3, t.maxX, py, edges, t.zA, zRow, t.zMax);
+                continue;
+            }
+#endif
+            rasterizeRowScalar(row, t.minX, t.maxX, py, edges, t.zA, zRow, t.zMax);
+        }
+    }
+}
+
+void OcclusionCuller::buildHiZ() {
+    int w = m_width, h = m_height;
+    for (size_t level = 1; level < m_levels.size(); ++level) {
+        const std::vector<float>& src = m_levels[level - 1];
+        std::vector<float>& dst = m_levels[level];
+        int dw = w / 2, dh = h / 2;
+        for (int y = 0; y < dh; ++y) {
+            const float* r0 = &src[static_cast<size_t>(2 * y) * w];
+            const float* r1 = r0 + w;
+            for (int x = 0; x < dw; ++x) {
+                dst[static_cast<size_t>(y) * dw + x] =
+                    std::max(std::max(r0[2 * x], r0[2 * x + 1]), std::max(r1[2 * x], r1[2 * x + 1]));
+            }
+        }
+        w = dw;
+        h = dh;
+    }
+}
+
+void OcclusionCuller::render(const glm::mat4& viewProjection, const glm::vec3& eye,
+                             const std::vector<AABB>& occluders, JobSystem& jobs) {
+    m_viewProjection = viewProjection;
+    m_stats = Stats();
+
+    selectOccluders(eye, occluders);
+    setupTriangles(occluders);
+    m_stats.occluders = m_selected.size();
+    m_stats.triangles = m_triangles.size();
+
+    // Bands share no pixels, so they rasterize without locking
+    int bands = (m_height + kBandRows - 1) / kBandRows;
+    jobs.parallelFor(static_cast<size_t>(bands), 1, [&](size_t begin, size_t end) {
+        for (size_t band = begin; band < end; ++band) {
+            int rowBegin = static_cast<int>(band) * kBandRows;
+            rasterizeBand(rowBegin, std::min(rowBegin + kBandRows, m_height));
+        }
+    });
+
+    buildHiZ();
+    m_ready = true;
+}
+
+bool OcclusionCuller::isOccluded(const glm::vec3& min, const glm::vec3& max) const {
+    if (!m_ready) return false;
+
+    // Corners as the projected min corner plus scaled matrix columns
+    glm::vec3 size = max - min;
+    glm::vec4 base = m_viewProjection * glm::vec4(min, 1.0f);
+    glm::vec4 axisX = m_viewProjection[0] * size.x;
+    glm::vec4 axisY = m_viewProjection[1] * size.y;
+    glm::vec4 axisZ = m_viewProjection[2] * size.z;
+
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1e30f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 clip = base;
+        if (i & 1) clip = clip + axisX;
+        if (i & 2) clip = clip + axisY;
+        if (i & 4) clip = clip + axisZ;
+        glm::vec3 screen;
+        if (!toScreen(clip, screen)) return false;
+        minX = std::min(minX, screen.x);
+        maxX = std::max(maxX, screen.x);
+        minY = std::min(minY, screen.y);
+        maxY = std::max(maxY, screen.y);
+        nearest = std::min(nearest, screen.z);
+    }
+
+    // Off screen is the frustum test's call, not ours
+    if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height) return false;
+    int x0 = std::max(0, static_cast<int>(minX));
+    int x1 = std::min(m_width - 1, static_cast<int>(maxX));
+    int y0 = std::max(0, static_cast<int>(minY));
+    int y1 = std::min(m_height - 1, static_cast<int>(maxY));
+
+    // Coarsest level where the rectangle spans at most 2x2 texels
+    int level = 0;
+    while (level + 1 < getLevelCount() &&
+           ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        ++level;
+    }
+
+    const std::vector<float>& hiz = m_levels[level];
+    int levelWidth = m_width >> level;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+            if (hiz[static_cast<size_t>(y) * levelWidth + x] >= nearest) return false;
+        }
+    }
+    return true;
+}
+
+void OcclusionCuller::cull(const AABBBatch& boxes, std::vector<uint32_t>& visible) {
+    size_t kept = 0;
+    for (uint32_t index : visible) {
+        if (!isOccluded(boxes.getMin(index), boxes.getMax(index))) {
+            visible[kept++] = index;
+        }
+    }
+    m_stats.tested += visible.size();
+    m_stats.occluded += visible.size() - kept;
+    visible.resize(kept);
+}
+
+} // namespace Engine
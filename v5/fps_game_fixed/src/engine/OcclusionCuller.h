@@ -0,0 +1,87 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include "BVH.h"
+#include "Raycast.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class JobSystem;
+
+// Software occlusion culling. render() rasterizes the biggest occluder
+// boxes into a small depth buffer on the CPU and builds a max-depth
+// hierarchy (HiZ) over it; isOccluded() then compares a box's nearest
+// depth against the coarsest HiZ level its screen rectangle fits in.
+//
+// Both halves err towards "visible": occluders only cover pixels they
+// cover completely, with their farthest depth inside the pixel, and any
+// triangle or box reaching behind the camera is skipped or kept.
+// Needs no GL, so it runs the same in the headless build.
+class OcclusionCuller {
+public:
+    struct Stats {
+        size_t occluders = 0;
+        size_t triangles = 0;
+        size_t tested = 0;
+        size_t occluded = 0;
+    };
+
+    // Sizes are rounded up to powers of two
+    explicit OcclusionCuller(int width = 256, int height = 128);
+
+    void setMaxOccluders(size_t count) { m_maxOccluders = count; }
+
+    // Clears the buffer and draws the occluders with the largest projected
+    // size, one band of rows per job
+    void render(const glm::mat4& viewProjection, const glm::vec3& eye,
+                const std::vector<AABB>& occluders, JobSystem& jobs);
+
+    // True only if the box is certainly hidden behind what render() drew
+    bool isOccluded(const glm::vec3& min, const glm::vec3& max) const;
+    // Drops the occluded boxes from 'visible' (indices into 'boxes')
+    void cull(const AABBBatch& boxes, std::vector<uint32_t>& visible);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+    // Depth in [0, 1] (1 = nothing drawn); level 0 is full resolution
+    const float* getDepth(int level = 0) const { return m_levels[level].data(); }
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    // Screen-space triangle with its depth plane z = zA * x + zB * y + zC
+    struct Triangle {
+        float x[3], y[3];
+        float zA, zB, zC;
+        float zMax;
+        int minX, maxX, minY, maxY;
+    };
+
+    void selectOccluders(const glm::vec3& eye, const std::vector<AABB>& occluders);
+    void setupTriangles(const std::vector<AABB>& occluders);
+    void addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+    void rasterizeBand(int rowBegin, int rowEnd);
+    void buildHiZ();
+    bool project(const glm::vec3& p, glm::vec3& screen) const;
+    bool toScreen(const glm::vec4& clip, glm::vec3& screen) const;
+
+    int m_width;
+    int m_height;
+    size_t m_maxOccluders;
+    bool m_ready;
+
+    glm::mat4 m_viewProjection;
+    std::vector<uint32_t> m_selected;
+    std::vector<float> m_scores;
+    std::vector<Triangle> m_triangles;
+    std::vector<std::vector<float>> m_levels;
+    Stats m_stats;
+};
+
+} // namespace Engine
+
+#endif // OCCLUSION_CULLER_H
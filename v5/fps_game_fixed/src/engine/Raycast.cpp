@@ -0,0 +1,171 @@
+#include "Raycast.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef ENGINE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Engine {
+
+void AABBBatch::clear() {
+    m_minX.clear(); m_minY.clear(); m_minZ.clear();
+    m_maxX.clear(); m_maxY.clear(); m_maxZ.clear();
+}
+
+void AABBBatch::reserve(size_t count) {
+    m_minX.reserve(count); m_minY.reserve(count); m_minZ.reserve(count);
+    m_maxX.reserve(count); m_maxY.reserve(count); m_maxZ.reserve(count);
+}
+
+void AABBBatch::add(const glm::vec3& min, const glm::vec3& max) {
+    m_minX.push_back(min.x); m_minY.push_back(min.y); m_minZ.push_back(min.z);
+    m_maxX.push_back(max.x); m_maxY.push_back(max.y); m_maxZ.push_back(max.z);
+}
+
+namespace {
+
+struct RaySetup {
+    glm::vec3 origin;
+    glm::vec3 invDir;
+    float maxDistance;
+};
+
+// Slab test for boxes [begin, end); lowers 'best' and sets 'bestIndex'
+// when a closer entry is found
+void slabScalar(const AABBBatch& b, const RaySetup& ray, size_t begin, size_t end,
+                float& best, size_t& bestIndex) {
+    for (size_t i = begin; i < end; ++i) {
+        float tx1 = (b.minX()[i] - ray.origin.x) * ray.invDir.x;
+        float tx2 = (b.maxX()[i] - ray.origin.x) * ray.invDir.x;
+        float ty1 = (b.minY()[i] - ray.origin.y) * ray.invDir.y;
+        float ty2 = (b.maxY()[i] - ray.origin.y) * ray.invDir.y;
+        float tz1 = (b.minZ()[i] - ray.origin.z) * ray.invDir.z;
+        float tz2 = (b.maxZ()[i] - ray.origin.z) * ray.invDir.z;
+
+        float tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)),
+                               std::max(std::min(tz1, tz2), 0.0f));
+        float tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                              std::min(std::max(tz1, tz2), ray.maxDistance));
+
+        if (tNear <= tFar && tNear < best) {
+            best = tNear;
+            bestIndex = i;
+        }
+    }
+}
+
+#ifdef ENGINE_X86_SIMD
+ENGINE_TARGET_AVX2
+void slabAVX2(const AABBBatch& b, const RaySetup& ray, size_t count,
+              float& best, size_t& bestIndex) {
+    const __m256 ox = _mm256_set1_ps(ray.origin.x);
+    const __m256 oy = _mm256_set1_ps(ray.origin.y);
+    const __m256 oz = _mm256_set1_ps(ray.origin.z);
+    const __m256 ix = _mm256_set1_ps(ray.invDir.x);
+    const __m256 iy = _mm256_set1_ps(ray.invDir.y);
+    const __m256 iz = _mm256_set1_ps(ray.invDir.z);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxT = _mm256_set1_ps(ray.maxDistance);
+
+    for (size_t i = 0; i + 8 <= count; i += 8) {
+        __m256 tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.minX() + i), ox), ix);
+        __m256 tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.maxX() + i), ox), ix);
+        __m256 ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.minY() + i), oy), iy);
+        __m256 ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.maxY() + i), oy), iy);
+        __m256 tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.minZ() + i), oz), iz);
+        __m256 tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.maxZ() + i), oz), iz);
+
+        __m256 tNear = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx1, tx2), _mm256_min_ps(ty1, ty2)),
+                                     _mm256_max_ps(_mm256_min_ps(tz1, tz2), zero));
+        __m256 tFar = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx1, tx2), _mm256_max_ps(ty1, ty2)),
+                                    _mm256_min_ps(_mm256_max_ps(tz1, tz2), maxT));
+
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ),
+                                   _mm256_cmp_ps(tNear, _mm256_set1_ps(best), _CMP_LT_OQ));
+        int mask = _mm256_movemask_ps(hit);
+        if (!mask) continue;
+
+        // Rare: pick the closest lane out of the few that hit
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, tNear);
+        for (int lane = 0; lane < 8; ++lane) {
+            if ((mask & (1 << lane)) && lanes[lane] < best) {
+                best = lanes[lane];
+                bestIndex = i + lane;
+            }
+        }
+    }
+}
+#endif
+
+} // namespace
+
+glm::vec3 safeInverseDirection(const glm::vec3& direction) {
+    const float eps = 1e-20f;
+    glm::vec3 inv;
+    for (int i = 0; i < 3; ++i) {
+        float d = direction[i];
+        if (std::fabs(d) < eps) d = d < 0.0f ? -eps : eps;
+        inv[i] = 1.0f / d;
+    }
+    return inv;
+}
+
+glm::vec3 boxEntryNormal(const glm::vec3& min, const glm::vec3& max,
+                         const glm::vec3& origin, const glm::vec3& direction, float t) {
+    if (t <= 0.0f) return -direction;
+
+    // The entry face is on the axis whose slab was entered last
+    int axis = 0;
+    float latest = -std::numeric_limits<float>::infinity();
+    for (int i = 0; i < 3; ++i) {
+        if (direction[i] == 0.0f) continue;
+        float inv = 1.0f / direction[i];
+        float entry = std::min((min[i] - origin[i]) * inv, (max[i] - origin[i]) * inv);
+        if (entry > latest) {
+            latest = entry;
+            axis = i;
+        }
+    }
+
+    glm::vec3 normal(0.0f);
+    normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+    return normal;
+}
+
+bool raycastBoxes(const AABBBatch& boxes, const glm::vec3& origin, const glm::vec3& direction,
+                  float maxDistance, RayHit& hit) {
+    if (boxes.empty()) return false;
+
+    glm::vec3 dir = glm::normalize(direction);
+    RaySetup ray;
+    ray.origin = origin;
+    ray.invDir = safeInverseDirection(dir);
+    ray.maxDistance = maxDistance;
+
+    float best = maxDistance + 1.0f;
+    size_t bestIndex = 0;
+    size_t done = 0;
+
+#ifdef ENGINE_X86_SIMD
+    if (CpuFeatures::get().avx2) {
+        slabAVX2(boxes, ray, boxes.size(), best, bestIndex);
+        done = boxes.size() - boxes.size() % 8;
+    }
+#endif
+    slabScalar(boxes, ray, done, boxes.size(), best, bestIndex);
+
+    if (best > maxDistance) return false;
+
+    hit.distance = best;
+    hit.point = origin + dir * best;
+    hit.index = bestIndex;
+    hit.normal = boxEntryNormal(boxes.getMin(bestIndex), boxes.getMax(bestIndex), origin, dir, best);
+
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,61 @@
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace Engine {
+
+struct RayHit {
+    float distance = 0.0f;
+    glm::vec3 point = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+    // Index of the box that was hit, in the order it was added
+    size_t index = 0;
+};
+
+// Axis-aligned boxes stored as six float arrays so the slab test can load
+// eight of them per AVX2 register
+class AABBBatch {
+public:
+    void clear();
+    void reserve(size_t count);
+    void add(const glm::vec3& min, const glm::vec3& max);
+
+    size_t size() const { return m_minX.size(); }
+    bool empty() const { return m_minX.empty(); }
+
+    glm::vec3 getMin(size_t i) const { return glm::vec3(m_minX[i], m_minY[i], m_minZ[i]); }
+    glm::vec3 getMax(size_t i) const { return glm::vec3(m_maxX[i], m_maxY[i], m_maxZ[i]); }
+
+    const float* minX() const { return m_minX.data(); }
+    const float* minY() const { return m_minY.data(); }
+    const float* minZ() const { return m_minZ.data(); }
+    const float* maxX() const { return m_maxX.data(); }
+    const float* maxY() const { return m_maxY.data(); }
+    const float* maxZ() const { return m_maxZ.data(); }
+
+private:
+    std::vector<float> m_minX, m_minY, m_minZ;
+    std::vector<float> m_maxX, m_maxY, m_maxZ;
+};
+
+// 1 / direction per axis, nudging zero components so the slab test never
+// computes 0 * inf
+glm::vec3 safeInverseDirection(const glm::vec3& direction);
+
+// Normal of the face a ray (unit 'direction') crosses when it enters the
+// box at distance t; -direction if it starts inside (t == 0)
+glm::vec3 boxEntryNormal(const glm::vec3& min, const glm::vec3& max,
+                         const glm::vec3& origin, const glm::vec3& direction, float t);
+
+// Nearest box the ray enters within [0, maxDistance]. Uses the AVX2 kernel
+// when the CPU has it, otherwise the scalar one; both give the same hit.
+// A ray starting inside a box hits it at distance 0 with normal -direction.
+bool raycastBoxes(const AABBBatch& boxes, const glm::vec3& origin, const glm::vec3& direction,
+                  float maxDistance, RayHit& hit);
+
+} // namespace Engine
+
+#endif // RAYCAST_H
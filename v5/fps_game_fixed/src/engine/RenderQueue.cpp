@@ -0,0 +1,184 @@
+#include "RenderQueue.h"
+#include "Mesh.h"
+#include "MeshLod.h"
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+// LSD radix sort on 8-bit digits. Digits every key shares (usually the
+// pass and shader bytes) are skipped instead of copied through.
+template <typename Entry>
+void radixSortEntries(std::vector<Entry>& entries, std::vector<Entry>& scratch) {
+    const size_t n = entries.size();
+    if (n < 2) return;
+    scratch.resize(n);
+
+    size_t counts[8][256];
+    std::memset(counts, 0, sizeof(counts));
+    for (const Entry& e : entries) {
+        for (int digit = 0; digit < 8; ++digit) {
+            ++counts[digit][(e.key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    Entry* src = entries.data();
+    Entry* dst = scratch.data();
+    for (int digit = 0; digit < 8; ++digit) {
+        size_t* count = counts[digit];
+        if (count[(src[0].key >> (digit * 8)) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            dst[count[(src[i].key >> (digit * 8)) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+} // namespace
+
+uint64_t RenderQueue::makeKey(RenderPass pass, RenderShader shader, uint32_t meshId, float depth) {
+    // Non-negative floats order the same as their bit patterns
+    uint32_t depthBits = 0;
+    if (depth > 0.0f) {
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    }
+    return (static_cast<uint64_t>(pass) & 0xF) << 60
+         | (static_cast<uint64_t>(shader) & 0xF) << 56
+         | (static_cast<uint64_t>(meshId) & 0xFFFFFF) << 32
+         | depthBits;
+}
+
+RenderQueue::RenderQueue()
+    : m_viewPosition(0.0f)
+    , m_occlusion(nullptr)
+    , m_culled(0)
+    , m_occluded(0)
+    , m_trianglesSaved(0)
+{
+}
+
+void RenderQueue::begin(const glm::vec3& viewPosition) {
+    m_viewPosition = viewPosition;
+    m_culled = 0;
+    m_occluded = 0;
+    m_trianglesSaved = 0;
+    m_keys.clear();
+    m_meshes.clear();
+    m_instances.clear();
+    m_batches.clear();
+    m_sorted.clear();
+    m_stats = RenderQueueStats();
+}
+
+void RenderQueue::submit(RenderPass pass, Mesh& mesh, const MeshInstance& instance,
+                         RenderShader shader) {
+    glm::vec3 offset = instance.position - m_viewPosition;
+    m_keys.push_back(makeKey(pass, shader, mesh.getId(), glm::dot(offset, offset)));
+    m_meshes.push_back(&mesh);
+    m_instances.push_back(instance);
+}
+
+void RenderQueue::submit(RenderPass pass, Mesh& mesh, const MeshInstance* instances, size_t count,
+                         RenderShader shader) {
+    for (size_t i = 0; i < count; ++i) {
+        submit(pass, mesh, instances[i], shader);
+    }
+}
+
+void RenderQueue::cullVisible(const MeshInstance* instances, size_t count) {
+    cullInstances(m_frustum, instances, count, m_cullBoxes, m_visible);
+    m_culled += count - m_visible.size();
+
+    if (m_occlusion) {
+        size_t inFrustum = m_visible.size();
+        m_occlusion->cull(m_cullBoxes, m_visible);
+        m_occluded += inFrustum - m_visible.size();
+    }
+}
+
+void RenderQueue::submitCulled(RenderPass pass, Mesh& mesh, const MeshInstance* instances, size_t count,
+                               RenderShader shader) {
+    cullVisible(instances, count);
+    for (uint32_t index : m_visible) {
+        submit(pass, mesh, instances[index], shader);
+    }
+}
+
+void RenderQueue::submitLod(RenderPass pass, const LodChain& chain, const MeshInstance* instances, size_t count,
+                            const uint8_t* levels, RenderShader shader) {
+    cullVisible(instances, count);
+
+    const unsigned int finest = chain.getTriangleCount(0);
+    const int last = static_cast<int>(chain.getLevelCount()) - 1;
+    for (uint32_t index : m_visible) {
+        int level = std::min(static_cast<int>(levels[index]), last);
+        m_trianglesSaved += finest - chain.getTriangleCount(level);
+        submit(pass, chain.getMesh(level), instances[index], shader);
+    }
+}
+
+void RenderQueue::sort() {
+    const size_t n = m_keys.size();
+    m_order.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_order[i].key = m_keys[i];
+        m_order[i].item = static_cast<uint32_t>(i);
+    }
+    radixSortEntries(m_order, m_scratch);
+
+    // Everything above the depth bits decides the batch
+    const uint64_t batchMask = ~static_cast<uint64_t>(0xFFFFFFFF);
+    m_sorted.resize(n);
+    m_batches.clear();
+    m_stats = RenderQueueStats();
+    m_stats.items = n;
+    m_stats.culled = m_culled;
+    m_stats.occluded = m_occluded;
+    m_stats.trianglesSaved = m_trianglesSaved;
+
+    uint64_t batchKey = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const SortEntry& entry = m_order[i];
+        m_sorted[i] = m_instances[entry.item];
+
+        Mesh* mesh = m_meshes[entry.item];
+        if (m_batches.empty() || (entry.key & batchMask) != batchKey || mesh != m_batches.back().mesh) {
+            Batch batch;
+            batch.pass = static_cast<RenderPass>(entry.key >> 60);
+            batch.shader = static_cast<RenderShader>((entry.key >> 56) & 0xF);
+            batch.mesh = mesh;
+            batch.first = i;
+            batch.count = 0;
+
+            if (m_batches.empty() || batch.shader != m_batches.back().shader) {
+                ++m_stats.shaderChanges;
+            }
+            if (m_batches.empty() || batch.mesh != m_batches.back().mesh) {
+                ++m_stats.meshChanges;
+            }
+            m_batches.push_back(batch);
+            batchKey = entry.key & batchMask;
+        }
+        ++m_batches.back().count;
+    }
+    m_stats.drawCalls = m_batches.size();
+    for (const Batch& batch : m_batches) {
+        m_stats.triangles += static_cast<size_t>(batch.mesh->getTriangleCount()) * batch.count;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,126 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "MeshInstance.h"
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+class Mesh;
+class LodChain;
+class OcclusionCuller;
+
+// Passes run in this order; within a pass draws go front to back
+enum class RenderPass : uint8_t {
+    OPAQUE = 0,
+    OVERLAY = 1 // view-model, drawn after the world
+};
+
+// Shader programs a draw can ask for. Only the lit instanced program
+// exists today; the key keeps room for more.
+enum class RenderShader : uint8_t {
+    LIT = 0
+};
+
+// Batching counters for the last sort(). "Saved" counts are relative to
+// drawing every item on its own, which binds a program and a VAO and
+// issues one draw per item.
+struct RenderQueueStats {
+    size_t items = 0;
+    size_t culled = 0;   // instances submitCulled() dropped outside the frustum
+    size_t occluded = 0; // ... and behind occluders
+    size_t drawCalls = 0;
+    size_t shaderChanges = 0;
+    size_t meshChanges = 0;
+    size_t triangles = 0;
+    size_t trianglesSaved = 0; // by drawing coarser LOD levels
+
+    size_t drawCallsSaved() const { return items - drawCalls; }
+    size_t stateChangesSaved() const { return 2 * items - shaderChanges - meshChanges; }
+};
+
+// Collects a frame's draws, sorts them by a 64-bit key
+// (pass | shader | mesh | depth) with a radix sort, and merges runs that
+// share mesh and shader into instanced batches for Renderer::execute.
+class RenderQueue {
+public:
+    // Consecutive sorted instances that draw with one instanced call
+    struct Batch {
+        RenderPass pass;
+        RenderShader shader;
+        Mesh* mesh;
+        size_t first;
+        size_t count;
+    };
+
+    RenderQueue();
+
+    // Starts a new frame; depth is measured from viewPosition
+    void begin(const glm::vec3& viewPosition);
+    // Frustum used by submitCulled() for the rest of the frame
+    void setFrustum(const Frustum& frustum) { m_frustum = frustum; }
+    // Optional occlusion test for submitCulled(), already rendered for
+    // this frame's camera; nullptr turns it off
+    void setOcclusion(OcclusionCuller* occlusion) { m_occlusion = occlusion; }
+
+    void submit(RenderPass pass, Mesh& mesh, const MeshInstance& instance,
+                RenderShader shader = RenderShader::LIT);
+    void submit(RenderPass pass, Mesh& mesh, const MeshInstance* instances, size_t count,
+                RenderShader shader = RenderShader::LIT);
+
+    // Submits only the unit-cube instances that touch the frustum and
+    // are not hidden behind occluders
+    void submitCulled(RenderPass pass, Mesh& mesh, const MeshInstance* instances, size_t count,
+                      RenderShader shader = RenderShader::LIT);
+    // submitCulled() drawing instance i with chain level levels[i]. The
+    // caller picks the levels (LodChain::select) and keeps them with the
+    // objects, so hysteresis survives reordering.
+    void submitLod(RenderPass pass, const LodChain& chain, const MeshInstance* instances, size_t count,
+                   const uint8_t* levels, RenderShader shader = RenderShader::LIT);
+
+    // Sorts everything submitted since begin() and builds the batches
+    void sort();
+
+    const std::vector<Batch>& getBatches() const { return m_batches; }
+    const std::vector<MeshInstance>& getSortedInstances() const { return m_sorted; }
+    const RenderQueueStats& getStats() const { return m_stats; }
+    size_t size() const { return m_keys.size(); }
+
+    // Bits 63-60 pass, 59-56 shader, 55-32 mesh id, 31-0 depth
+    static uint64_t makeKey(RenderPass pass, RenderShader shader, uint32_t meshId, float depth);
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    // Frustum and occlusion tests into m_visible
+    void cullVisible(const MeshInstance* instances, size_t count);
+
+    glm::vec3 m_viewPosition;
+    Frustum m_frustum;
+    OcclusionCuller* m_occlusion;
+    size_t m_culled;
+    size_t m_occluded;
+    size_t m_trianglesSaved;
+    AABBBatch m_cullBoxes;
+    std::vector<uint32_t> m_visible;
+    std::vector<uint64_t> m_keys;
+    std::vector<Mesh*> m_meshes;
+    std::vector<MeshInstance> m_instances;
+
+    std::vector<SortEntry> m_order;
+    std::vector<SortEntry> m_scratch;
+    std::vector<MeshInstance> m_sorted;
+    std::vector<Batch> m_batches;
+    RenderQueueStats m_stats;
+};
+
+} // namespace Engine
+
+#endif // RENDER_QUEUE_H
@@ -1,33 +1,124 @@
 #include "Renderer.h"
 #include <glad/glad.h>
+#include <chrono>
+#include <iostream>
 
 namespace Engine {
 
+// std140 mirrors of the shader uniform blocks
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 lightPos;
+    glm::vec4 viewPos;
+};
+
+struct ObjectConstants {
+    glm::mat4 model;
+    glm::vec4 objectColor;
+};
+
+static_assert(sizeof(FrameConstants) == 160, "FrameConstants must match the std140 block");
+static_assert(sizeof(ObjectConstants) == 80, "ObjectConstants must match the std140 block");
+
+static const GLuint kFrameBinding = 0;
+static const GLuint kObjectBinding = 1;
+
+// Vertices arrive in one of Mesh's compact layouts: positions are
+// rescaled by the mesh's aPosScale/aPosBias (constant attributes set per
+// draw) and normals are octahedral-encoded.
 static const char* vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec2 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 layout (location = 3) in vec3 aColor;
+layout (location = 7) in vec3 aPosScale;
+layout (location = 8) in vec3 aPosBias;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 out vec3 Color;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 viewPos;
+};
+
+layout (std140) uniform ObjectConstants {
+    mat4 model;
+    vec4 objectColor;
+};
+
+vec3 decodeNormal(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(model * vec4(aPos * aPosScale + aPosBias, 1.0));
+    Normal = mat3(transpose(inverse(model))) * decodeNormal(aNormal);
     TexCoord = aTexCoord;
     Color = aColor;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
 )";
 
+// Same lighting as vertexShaderSource, but the model transform comes from
+// per-instance attributes. Instances are only translated and scaled, so the
+// normal matrix reduces to dividing by the scale.
+static const char* instancedVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec3 aColor;
+layout (location = 4) in vec3 iPosition;
+layout (location = 5) in vec3 iScale;
+layout (location = 6) in vec3 iColor;
+layout (location = 7) in vec3 aPosScale;
+layout (location = 8) in vec3 aPosBias;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+out vec3 Color;
+
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 viewPos;
+};
+
+layout (std140) uniform ObjectConstants {
+    mat4 model;
+    vec4 objectColor;
+};
+
+vec3 decodeNormal(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+void main() {
+    FragPos = (aPos * aPosScale + aPosBias) * iScale + iPosition;
+    Normal = decodeNormal(aNormal) / iScale;
+    TexCoord = aTexCoord;
+    Color = aColor * iColor;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
+)";
+
 static const char* fragmentShaderSource = R"(
 #version 330 core
 out vec4 FragColor;
@@ -37,9 +128,17 @@ in vec3 Normal;
 in vec2 TexCoord;
 in vec3 Color;
 
-uniform vec3 objectColor;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 viewPos;
+};
+
+layout (std140) uniform ObjectConstants {
+    mat4 model;
+    vec4 objectColor;
+};
 
 void main() {
     // Ambient
@@ -48,24 +147,28 @@ void main() {
 
     // Diffuse
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diff * vec3(1.0);
 
     // Specular
     float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     vec3 specular = specularStrength * spec * vec3(1.0);
 
-    vec3 result = (ambient + diffuse + specular) * objectColor * Color;
+    vec3 result = (ambient + diffuse + specular) * objectColor.rgb * Color;
     FragColor = vec4(result, 1.0);
 }
 )";
 
 Renderer::Renderer()
-    : m_camera(nullptr)
+    : m_instanceBuffer(0)
+    , m_frameBuffer(0)
+    , m_objectBuffer(0)
+    , m_boundShader(nullptr)
+    , m_camera(nullptr)
     , m_viewportWidth(800)
     , m_viewportHeight(600)
 {
@@ -75,35 +178,153 @@ Renderer::~Renderer() {
 }
 
 bool Renderer::init() {
-    if (!m_shader.loadFromString(vertexShaderSource, fragmentShaderSource)) {
+    // Both programs are submitted before either is waited on, so drivers
+    // with parallel compile build them side by side
+    m_loadStart = std::chrono::steady_clock::now();
+    m_shaderCache.init(m_shaderCacheDirectory);
+    if (!m_shaderCache.submit(m_shader, "lit", vertexShaderSource, fragmentShaderSource) ||
+        !m_shaderCache.submit(m_instancedShader, "lit-instanced", instancedVertexShaderSource, fragmentShaderSource)) {
+        return false;
+    }
+
+    glGenBuffers(1, &m_instanceBuffer);
+
+    // Both blocks stay bound for the renderer's lifetime; draws only
+    // rewrite their contents
+    glGenBuffers(1, &m_frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kFrameBinding, m_frameBuffer);
+
+    glGenBuffers(1, &m_objectBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_objectBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(ObjectConstants), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kObjectBinding, m_objectBuffer);
+    return true;
+}
+
+bool Renderer::isReady() {
+    return m_shaderCache.isReady();
+}
+
+bool Renderer::finishLoading() {
+    if (!m_shaderCache.finish()) {
         return false;
     }
+
+    Shader* shaders[] = { &m_shader, &m_instancedShader };
+    for (Shader* shader : shaders) {
+        if (!shader->bindUniformBlock("FrameConstants", kFrameBinding) ||
+            !shader->bindUniformBlock("ObjectConstants", kObjectBinding)) {
+            return false;
+        }
+    }
+
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_loadStart).count();
+    if (m_shaderCache.isEnabled()) {
+        std::cout << "Shader cache: " << m_shaderCache.getHits() << " hits, " << m_shaderCache.getMisses()
+                  << " misses (" << m_shaderCache.getRejected() << " unusable), "
+                  << loadMs << " ms" << std::endl;
+    } else {
+        std::cout << "Shaders compiled from source in " << loadMs << " ms" << std::endl;
+    }
     return true;
 }
 
+void Renderer::shutdown() {
+    // Shared meshes must release their GL objects while the context is alive
+    m_meshes.clear();
+    m_textures.shutdown();
+
+    GLuint* buffers[] = { &m_instanceBuffer, &m_frameBuffer, &m_objectBuffer };
+    for (GLuint* buffer : buffers) {
+        if (*buffer) {
+            glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+    }
+    m_boundShader = nullptr;
+}
+
 void Renderer::clear(const glm::vec3& color) {
     // FIX: use .x/.y/.z — the custom GLM stub has no .r/.g/.b aliases
     glClearColor(color.x, color.y, color.z, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void Renderer::renderMesh(Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
-    if (!m_camera) return;
+void Renderer::beginFrame() {
+    if (!m_camera || !m_frameBuffer) return;
 
-    m_shader.use();
+    float aspect = (float)m_viewportWidth / (float)m_viewportHeight;
 
-    m_shader.setMat4("model", model);
-    m_shader.setMat4("view", m_camera->getViewMatrix());
+    FrameConstants frame;
+    frame.view = m_camera->getViewMatrix();
+    frame.projection = m_camera->getProjectionMatrix(aspect);
+    frame.lightPos = glm::vec4(5.0f, 10.0f, 5.0f, 1.0f);
+    frame.viewPos = glm::vec4(m_camera->getPosition(), 1.0f);
 
-    float aspect = (float)m_viewportWidth / (float)m_viewportHeight;
-    m_shader.setMat4("projection", m_camera->getProjectionMatrix(aspect));
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &frame);
 
-    m_shader.setVec3("objectColor", color);
-    m_shader.setVec3("lightPos", glm::vec3(5.0f, 10.0f, 5.0f));
-    m_shader.setVec3("viewPos", m_camera->getPosition());
+    // Something else may have changed the program since last frame
+    m_boundShader = nullptr;
+}
 
+void Renderer::useShader(Shader& shader) {
+    if (m_boundShader != &shader) {
+        shader.use();
+        m_boundShader = &shader;
+    }
+}
+
+void Renderer::setObjectConstants(const glm::mat4& model, const glm::vec3& color) {
+    ObjectConstants object;
+    object.model = model;
+    object.objectColor = glm::vec4(color, 1.0f);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_objectBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ObjectConstants), &object);
+}
+
+void Renderer::renderMesh(Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
+    if (!m_camera || !m_objectBuffer) return;
+
+    useShader(m_shader);
+    setObjectConstants(model, color);
     mesh.draw();
-    m_shader.unbind();
+}
+
+void Renderer::uploadInstances(const MeshInstance* instances, size_t count) {
+    // Orphan the last upload's storage so the driver never waits on a draw
+    // that is still reading it
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(count * sizeof(MeshInstance));
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Instances carry their own transform and color
+    useShader(m_instancedShader);
+    setObjectConstants(glm::mat4(1.0f), glm::vec3(1.0f));
+}
+
+void Renderer::renderInstanced(Mesh& mesh, const MeshInstance* instances, size_t count) {
+    if (!m_camera || !m_instanceBuffer || count == 0) return;
+
+    uploadInstances(instances, count);
+    mesh.drawInstanced(m_instanceBuffer, 0, static_cast<GLsizei>(count));
+}
+
+void Renderer::execute(const RenderQueue& queue) {
+    const std::vector<MeshInstance>& instances = queue.getSortedInstances();
+    if (!m_camera || !m_instanceBuffer || instances.empty()) return;
+
+    // Batches are contiguous runs of the sorted instances, so one upload
+    // covers the frame and each draw starts at its batch's offset
+    uploadInstances(instances.data(), instances.size());
+    for (const RenderQueue::Batch& batch : queue.getBatches()) {
+        batch.mesh->drawInstanced(m_instanceBuffer, batch.first, static_cast<GLsizei>(batch.count));
+    }
 }
 
 void Renderer::setViewport(int width, int height) {
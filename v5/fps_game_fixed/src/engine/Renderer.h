@@ -2,9 +2,16 @@
 #define RENDERER_H
 
 #include "Shader.h"
+#include "ShaderCache.h"
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshInstance.h"
+#include "RenderQueue.h"
+#include "TextureStreamer.h"
 #include "Camera.h"
 #include <glm/glm.hpp>
+#include <chrono>
+#include <string>
 
 namespace Engine {
 
@@ -13,17 +20,53 @@ public:
     Renderer();
     ~Renderer();
 
+    // Where init() keeps compiled shader programs; empty disables the cache
+    void setShaderCacheDirectory(const std::string& directory) { m_shaderCacheDirectory = directory; }
+    // Creates the GL buffers and starts building the shaders; poll
+    // isReady() (e.g. while drawing a loading screen) and call
+    // finishLoading() before the first draw
     bool init();
+    bool isReady();
+    bool finishLoading();
+    void shutdown();
     void clear(const glm::vec3& color = glm::vec3(0.1f, 0.1f, 0.15f));
+    // Uploads the per-frame uniform block (camera matrices, light, eye
+    // position). Call once per frame after setCamera and before any draw.
+    void beginFrame();
     
+    // Per draw only the model matrix and color are uploaded
     void renderMesh(Mesh& mesh, const glm::mat4& model, const glm::vec3& color = glm::vec3(1.0f));
+    // One draw call for all instances; they are streamed into a shared
+    // instance buffer that is orphaned and refilled on every call
+    void renderInstanced(Mesh& mesh, const MeshInstance* instances, size_t count);
+    // Draws a sorted queue: the instances are uploaded once, then one
+    // instanced call per batch
+    void execute(const RenderQueue& queue);
     void setCamera(Camera* camera) { m_camera = camera; }
     void setViewport(int width, int height);
+    float getAspectRatio() const { return (float)m_viewportWidth / (float)m_viewportHeight; }
 
     Shader* getShader() { return &m_shader; }
+    MeshCache& getMeshCache() { return m_meshes; }
+    TextureStreamer& getTextureStreamer() { return m_textures; }
 
 private:
+    void useShader(Shader& shader);
+    void setObjectConstants(const glm::mat4& model, const glm::vec3& color);
+    // Refills the instance buffer and binds the instanced shader
+    void uploadInstances(const MeshInstance* instances, size_t count);
+
     Shader m_shader;
+    Shader m_instancedShader;
+    ShaderCache m_shaderCache;
+    std::string m_shaderCacheDirectory;
+    std::chrono::steady_clock::time_point m_loadStart;
+    GLuint m_instanceBuffer;
+    GLuint m_frameBuffer;  // FrameConstants uniform block
+    GLuint m_objectBuffer; // ObjectConstants uniform block
+    Shader* m_boundShader; // program left bound by the last draw
+    MeshCache m_meshes;
+    TextureStreamer m_textures;
     Camera* m_camera;
     int m_viewportWidth;
     int m_viewportHeight;
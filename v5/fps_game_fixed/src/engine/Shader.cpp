@@ -1,79 +1,181 @@
 #include "Shader.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 namespace Engine {
 
-Shader::Shader() : m_program(0) {
+namespace {
+
+// GL_KHR_parallel_shader_compile (or its ARB twin) lets the driver
+// compile on its own threads and answer COMPLETION_STATUS without
+// blocking. Checked once, on the first compile.
+bool parallelCompileAvailable() {
+    static const bool available = []() {
+        bool supported = SDL_GL_ExtensionSupported("GL_KHR_parallel_shader_compile") ||
+                         SDL_GL_ExtensionSupported("GL_ARB_parallel_shader_compile");
+        if (!supported || !glMaxShaderCompilerThreadsKHR) return false;
+        // Let the driver pick the thread count
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        return true;
+    }();
+    return available;
 }
 
-Shader::~Shader() {
-    if (m_program) {
-        glDeleteProgram(m_program);
-    }
-}
-
-GLuint Shader::compileShader(GLenum type, const std::string& source) {
+GLuint submitShader(GLenum type, const std::string& source) {
     GLuint shader = glCreateShader(type);
     const char* src = source.c_str();
     glShaderSource(shader, 1, &src, nullptr);
     glCompileShader(shader);
+    return shader;
+}
 
+bool checkShader(GLuint shader, const char* stage) {
     GLint success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
         GLint length;
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-        std::vector<char> log(length);
+        std::vector<char> log(std::max(length, 1));
         glGetShaderInfoLog(shader, length, &length, log.data());
-        std::cerr << "Shader compilation failed:\n" << log.data() << std::endl;
-        glDeleteShader(shader);
-        return 0;
+        std::cerr << stage << " shader compilation failed:\n" << log.data() << std::endl;
+        return false;
     }
+    return true;
+}
 
-    return shader;
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+Shader::Shader()
+    : m_program(0)
+    , m_vertexShader(0)
+    , m_fragmentShader(0)
+    , m_compileMs(0.0)
+{
 }
 
-bool Shader::linkProgram(GLuint vertex, GLuint fragment) {
+Shader::~Shader() {
+    release();
+}
+
+void Shader::release() {
+    if (m_vertexShader) {
+        glDeleteShader(m_vertexShader);
+        glDeleteShader(m_fragmentShader);
+        m_vertexShader = 0;
+        m_fragmentShader = 0;
+    }
+    if (m_program) {
+        glDeleteProgram(m_program);
+        m_program = 0;
+    }
+    m_uniformLocations.clear();
+}
+
+bool Shader::beginCompile(const std::string& vertexSrc, const std::string& fragmentSrc) {
+    release();
+    m_compileStart = std::chrono::steady_clock::now();
+    m_compileMs = -1.0;
+    parallelCompileAvailable();
+
+    m_vertexShader = submitShader(GL_VERTEX_SHADER, vertexSrc);
+    m_fragmentShader = submitShader(GL_FRAGMENT_SHADER, fragmentSrc);
+
     m_program = glCreateProgram();
-    glAttachShader(m_program, vertex);
-    glAttachShader(m_program, fragment);
+    glAttachShader(m_program, m_vertexShader);
+    glAttachShader(m_program, m_fragmentShader);
+    // Keeps the binary around for getBinary(); drivers without
+    // program binaries don't load the entry point
+    if (glProgramParameteri) {
+        glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    // Linking a program whose shaders failed just fails too; the compile
+    // logs are read in finishCompile()
     glLinkProgram(m_program);
+    return m_program != 0;
+}
 
-    GLint success;
-    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
-    if (!success) {
-        GLint length;
-        glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &length);
-        std::vector<char> log(length);
-        glGetProgramInfoLog(m_program, length, &length, log.data());
-        std::cerr << "Shader linking failed:\n" << log.data() << std::endl;
-        return false;
+bool Shader::isReady() {
+    if (!isPending()) return true;
+    // Without the extension any status query blocks, so report ready
+    // and let finishCompile() take the wait
+    if (!parallelCompileAvailable()) return true;
+
+    GLint done = GL_FALSE;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &done);
+    if (done && m_compileMs < 0.0) {
+        m_compileMs = elapsedMs(m_compileStart);
     }
+    return done != GL_FALSE;
+}
 
-    return true;
+bool Shader::finishCompile() {
+    if (!isPending()) return m_program != 0;
+
+    bool ok = checkShader(m_vertexShader, "Vertex") && checkShader(m_fragmentShader, "Fragment");
+    if (ok) {
+        GLint success;
+        glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+        if (!success) {
+            GLint length;
+            glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &length);
+            std::vector<char> log(std::max(length, 1));
+            glGetProgramInfoLog(m_program, length, &length, log.data());
+            std::cerr << "Shader linking failed:\n" << log.data() << std::endl;
+            ok = false;
+        }
+    }
+    if (m_compileMs < 0.0) {
+        m_compileMs = elapsedMs(m_compileStart);
+    }
+
+    // The program keeps what it needs once linked
+    glDeleteShader(m_vertexShader);
+    glDeleteShader(m_fragmentShader);
+    m_vertexShader = 0;
+    m_fragmentShader = 0;
+    if (!ok) {
+        release();
+    }
+    return ok;
 }
 
 bool Shader::loadFromString(const std::string& vertexSrc, const std::string& fragmentSrc) {
-    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSrc);
-    if (!vertexShader) return false;
+    return beginCompile(vertexSrc, fragmentSrc) && finishCompile();
+}
 
-    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSrc);
-    if (!fragmentShader) {
-        glDeleteShader(vertexShader);
-        return false;
-    }
+bool Shader::loadFromBinary(GLenum format, const std::vector<uint8_t>& binary) {
+    if (!glProgramBinary || binary.empty()) return false;
 
-    if (!linkProgram(vertexShader, fragmentShader)) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+    release();
+    m_program = glCreateProgram();
+    glProgramBinary(m_program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint success;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+    if (!success) {
+        release();
         return false;
     }
+    return true;
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+bool Shader::getBinary(GLenum& format, std::vector<uint8_t>& binary) const {
+    if (!m_program || !glGetProgramBinary) return false;
 
-    return true;
+    GLint length = 0;
+    glGetProgramiv(m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    binary.resize(length);
+    GLsizei written = 0;
+    glGetProgramBinary(m_program, length, &written, &format, binary.data());
+    binary.resize(written);
+    return written > 0;
 }
 
 void Shader::use() {
@@ -85,7 +187,23 @@ void Shader::unbind() {
 }
 
 GLint Shader::getUniformLocation(const std::string& name) {
-    return glGetUniformLocation(m_program, name.c_str());
+    auto it = m_uniformLocations.find(name);
+    if (it != m_uniformLocations.end()) {
+        return it->second;
+    }
+    GLint location = glGetUniformLocation(m_program, name.c_str());
+    m_uniformLocations.emplace(name, location);
+    return location;
+}
+
+bool Shader::bindUniformBlock(const std::string& name, GLuint binding) {
+    GLuint index = glGetUniformBlockIndex(m_program, name.c_str());
+    if (index == GL_INVALID_INDEX) {
+        std::cerr << "Uniform block not found: " << name << std::endl;
+        return false;
+    }
+    glUniformBlockBinding(m_program, index, binding);
+    return true;
 }
 
 void Shader::setInt(const std::string& name, int value) {
@@ -2,7 +2,11 @@
 #define SHADER_H
 
 #include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -14,7 +18,28 @@ public:
     Shader();
     ~Shader();
 
+    // Compiles and links, waiting for the driver; same as beginCompile()
+    // followed by finishCompile()
     bool loadFromString(const std::string& vertexSrc, const std::string& fragmentSrc);
+    // Hands both stages and the link to the driver without waiting for or
+    // checking any of it, so several programs can compile at once
+    bool beginCompile(const std::string& vertexSrc, const std::string& fragmentSrc);
+    // True once finishCompile() won't block. Only drivers with
+    // GL_KHR_parallel_shader_compile can tell; others always say true.
+    bool isReady();
+    // Waits for the pending compile and reports its errors; on failure
+    // the shader is left without a program
+    bool finishCompile();
+    bool isPending() const { return m_vertexShader != 0; }
+    // Submit-to-ready time of the last compile (or until finishCompile()
+    // if readiness was never polled)
+    double getCompileMs() const { return m_compileMs; }
+
+    // Restores a program saved by getBinary(); false (and no program)
+    // if the driver rejects it, e.g. after a driver update
+    bool loadFromBinary(GLenum format, const std::vector<uint8_t>& binary);
+    // The linked program in the driver's binary format, if it exposes one
+    bool getBinary(GLenum& format, std::vector<uint8_t>& binary) const;
     void use();
     void unbind();
 
@@ -24,13 +49,24 @@ public:
     void setVec4(const std::string& name, const glm::vec4& value);
     void setMat4(const std::string& name, const glm::mat4& value);
 
+    // Points the named uniform block at a GL_UNIFORM_BUFFER binding slot
+    bool bindUniformBlock(const std::string& name, GLuint binding);
+
     GLuint getID() const { return m_program; }
 
 private:
     GLuint m_program;
-    GLuint compileShader(GLenum type, const std::string& source);
-    bool linkProgram(GLuint vertex, GLuint fragment);
+    // Stages of a compile started by beginCompile(), until finishCompile()
+    GLuint m_vertexShader;
+    GLuint m_fragmentShader;
+    std::chrono::steady_clock::time_point m_compileStart;
+    double m_compileMs;
+
     GLint getUniformLocation(const std::string& name);
+    void release();
+
+    // Locations never change after linking, so each is looked up once
+    std::unordered_map<std::string, GLint> m_uniformLocations;
 };
 
 } // namespace Engine
@@ -0,0 +1,231 @@
+#include "ShaderCache.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace Engine {
+
+// File layout: "FPSB" u16 version, u64 key, u32 format, u32 length, then
+// the driver's binary. Integers are native-endian; the files never leave
+// the machine that wrote them.
+static const char kMagic[4] = {'F', 'P', 'S', 'B'};
+static const uint16_t kVersion = 1;
+
+namespace {
+
+// FNV-1a, with a separator so "ab" + "c" and "a" + "bc" differ
+void hashString(uint64_t& hash, const std::string& text) {
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    hash = (hash ^ 0xFF) * 1099511628211ull;
+}
+
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+std::string withDefines(const std::string& source, const std::vector<std::string>& defines) {
+    if (defines.empty()) return source;
+
+    std::string block;
+    for (const std::string& define : defines) {
+        block += "#define " + define + "\n";
+    }
+    // #version has to stay the first statement
+    size_t lineStart = source.find_first_not_of(" \t\r\n");
+    if (lineStart != std::string::npos && source.compare(lineStart, 8, "#version") == 0) {
+        size_t lineEnd = source.find('\n', lineStart);
+        if (lineEnd == std::string::npos) return source + "\n" + block;
+        return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+    }
+    return block + source;
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return static_cast<size_t>(in.gcount()) == sizeof(value);
+}
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+ShaderCache::ShaderCache()
+    : m_enabled(false)
+    , m_hits(0)
+    , m_misses(0)
+    , m_rejected(0)
+{
+}
+
+void ShaderCache::init(const std::string& directory) {
+    m_directory = directory;
+    m_enabled = false;
+    if (directory.empty() || !glGetProgramBinary || !glProgramBinary) return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        std::cout << "Shader cache: driver exposes no program binary formats" << std::endl;
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Shader cache: cannot create " << directory << ": " << error.message() << std::endl;
+        return;
+    }
+
+    m_driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    m_enabled = true;
+}
+
+bool ShaderCache::load(Shader& shader, const std::string& name, const std::string& vertexSrc,
+                       const std::string& fragmentSrc, const std::vector<std::string>& defines) {
+    return submit(shader, name, vertexSrc, fragmentSrc, defines) && finish();
+}
+
+bool ShaderCache::submit(Shader& shader, const std::string& name, const std::string& vertexSrc,
+                         const std::string& fragmentSrc, const std::vector<std::string>& defines) {
+    auto start = std::chrono::steady_clock::now();
+    std::string vertex = withDefines(vertexSrc, defines);
+    std::string fragment = withDefines(fragmentSrc, defines);
+
+    Pending pending;
+    pending.shader = &shader;
+    pending.name = name;
+    pending.key = 0;
+
+    if (m_enabled) {
+        // The expanded sources already carry the defines
+        pending.key = 14695981039346656037ull;
+        hashString(pending.key, m_driver);
+        hashString(pending.key, vertex);
+        hashString(pending.key, fragment);
+        pending.path = pathFor(pending.key);
+
+        GLenum format = 0;
+        std::vector<uint8_t> binary;
+        ReadResult read = readBinary(pending.path, pending.key, format, binary);
+        if (read == ReadResult::OK) {
+            if (shader.loadFromBinary(format, binary)) {
+                ++m_hits;
+                std::cout << "Shader '" << name << "': loaded from cache in "
+                          << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                          << " ms" << std::endl;
+                return true;
+            }
+            ++m_rejected;
+        } else if (read == ReadResult::INVALID) {
+            ++m_rejected;
+        }
+        ++m_misses;
+    }
+
+    if (!shader.beginCompile(vertex, fragment)) {
+        return false;
+    }
+    m_pending.push_back(std::move(pending));
+    return true;
+}
+
+bool ShaderCache::isReady() {
+    for (Pending& pending : m_pending) {
+        if (!pending.shader->isReady()) return false;
+    }
+    return true;
+}
+
+bool ShaderCache::finish() {
+    bool ok = true;
+    for (Pending& pending : m_pending) {
+        if (!pending.shader->finishCompile()) {
+            std::cerr << "Shader '" << pending.name << "' failed to build" << std::endl;
+            ok = false;
+            continue;
+        }
+        std::cout << "Shader '" << pending.name << "': compiled in "
+                  << pending.shader->getCompileMs() << " ms" << std::endl;
+
+        GLenum format = 0;
+        std::vector<uint8_t> binary;
+        if (!pending.path.empty() && pending.shader->getBinary(format, binary)) {
+            writeBinary(pending.path, pending.key, format, binary);
+        }
+    }
+    m_pending.clear();
+    return ok;
+}
+
+std::string ShaderCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+ShaderCache::ReadResult ShaderCache::readBinary(const std::string& path, uint64_t key, GLenum& format,
+                                                std::vector<uint8_t>& binary) const {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return ReadResult::MISSING;
+    std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+
+    char magic[4];
+    uint16_t version;
+    uint64_t storedKey;
+    uint32_t storedFormat, length;
+    in.read(magic, sizeof(magic));
+    if (in.gcount() != sizeof(magic) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) return ReadResult::INVALID;
+    if (!readValue(in, version) || version != kVersion) return ReadResult::INVALID;
+    if (!readValue(in, storedKey) || storedKey != key) return ReadResult::INVALID;
+    if (!readValue(in, storedFormat) || !readValue(in, length)) return ReadResult::INVALID;
+
+    // Check the length against what is really there before allocating
+    // for it, so a damaged file can't ask for gigabytes
+    std::streamoff remaining = fileSize - in.tellg();
+    if (length == 0 || static_cast<std::streamoff>(length) != remaining) return ReadResult::INVALID;
+
+    binary.resize(length);
+    in.read(reinterpret_cast<char*>(binary.data()), length);
+    if (static_cast<size_t>(in.gcount()) != length) return ReadResult::INVALID;
+    format = storedFormat;
+    return ReadResult::OK;
+}
+
+bool ShaderCache::writeBinary(const std::string& path, uint64_t key, GLenum format,
+                              const std::vector<uint8_t>& binary) const {
+    // Written aside and renamed, so a crash never leaves a torn file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(kMagic, sizeof(kMagic));
+        writeValue(out, kVersion);
+        writeValue(out, key);
+        writeValue(out, static_cast<uint32_t>(format));
+        writeValue(out, static_cast<uint32_t>(binary.size()));
+        out.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+        if (!out) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) {
+        std::cerr << "Shader cache: cannot write " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temp, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,74 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include "Shader.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// Keeps linked programs on disk (glGetProgramBinary) so later launches
+// skip compiling. Files are keyed by a hash of the sources, the defines
+// and the driver's vendor/renderer/version strings, so a driver update
+// simply misses. Binaries the driver refuses anyway are recompiled from
+// source and overwritten.
+class ShaderCache {
+public:
+    ShaderCache();
+
+    // Needs a current GL context. An empty directory, or a driver without
+    // program binary formats, leaves the cache off: load() then always
+    // compiles.
+    void init(const std::string& directory);
+
+    // Builds 'shader' from the cache or from source, waiting for the
+    // driver. Each define ("NAME" or "NAME VALUE") is inserted after the
+    // #version line; 'name' only labels the log lines.
+    bool load(Shader& shader, const std::string& name, const std::string& vertexSrc,
+              const std::string& fragmentSrc, const std::vector<std::string>& defines = {});
+
+    // Split form of load() for building many programs at once: submit()
+    // restores cache hits right away and starts compiling the rest,
+    // isReady() polls without blocking, and finish() waits for whatever
+    // is left, logs each program's compile time and stores the binaries.
+    // 'shader' must stay alive until finish().
+    bool submit(Shader& shader, const std::string& name, const std::string& vertexSrc,
+                const std::string& fragmentSrc, const std::vector<std::string>& defines = {});
+    bool isReady();
+    bool finish();
+
+    bool isEnabled() const { return m_enabled; }
+    size_t getHits() const { return m_hits; }
+    size_t getMisses() const { return m_misses; }
+    // Cache files that were found but unusable: corrupt or truncated, or
+    // refused by the driver. Also counted as misses.
+    size_t getRejected() const { return m_rejected; }
+
+private:
+    struct Pending {
+        Shader* shader;
+        std::string name;
+        std::string path; // empty when the cache is off
+        uint64_t key;
+    };
+
+    enum class ReadResult { MISSING, INVALID, OK };
+
+    std::string pathFor(uint64_t key) const;
+    ReadResult readBinary(const std::string& path, uint64_t key, GLenum& format, std::vector<uint8_t>& binary) const;
+    bool writeBinary(const std::string& path, uint64_t key, GLenum format, const std::vector<uint8_t>& binary) const;
+
+    std::string m_directory;
+    std::string m_driver;
+    bool m_enabled;
+    size_t m_hits;
+    size_t m_misses;
+    size_t m_rejected;
+    std::vector<Pending> m_pending;
+};
+
+} // namespace Engine
+
+#endif // SHADER_CACHE_H
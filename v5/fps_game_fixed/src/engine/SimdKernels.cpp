@@ -0,0 +1,177 @@
+#include "SimdKernels.h"
+#include "CpuFeatures.h"
+
+#ifdef ENGINE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Engine {
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "vec3 arrays must be packed floats");
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+namespace {
+
+// ---- Scalar: also handles the tails of the wide kernels ----
+
+void addScalar(float* data, size_t count, float value) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] += value;
+    }
+}
+
+void scaleScalar(float* data, size_t count, float factor) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] *= factor;
+    }
+}
+
+void integrateScalar(glm::vec3* positions, glm::vec3* velocities, size_t count,
+                     const glm::vec3& acceleration, float dt) {
+    glm::vec3 dv = acceleration * dt;
+    for (size_t i = 0; i < count; ++i) {
+        velocities[i] += dv;
+        positions[i] += velocities[i] * dt;
+    }
+}
+
+#ifdef ENGINE_X86_SIMD
+
+// ---- SSE2: 4 floats, or 4 particles as three xyzx/yzxy/zxyz registers ----
+
+ENGINE_TARGET_SSE2
+void addSSE2(float* data, size_t count, float value) {
+    const __m128 v = _mm_set1_ps(value);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), v));
+    }
+    addScalar(data + i, count - i, value);
+}
+
+ENGINE_TARGET_SSE2
+void scaleSSE2(float* data, size_t count, float factor) {
+    const __m128 f = _mm_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), f));
+    }
+    scaleScalar(data + i, count - i, factor);
+}
+
+ENGINE_TARGET_SSE2
+void integrateSSE2(glm::vec3* positions, glm::vec3* velocities, size_t count,
+                   const glm::vec3& acceleration, float dt) {
+    glm::vec3 dv = acceleration * dt;
+    const __m128 dv0 = _mm_setr_ps(dv.x, dv.y, dv.z, dv.x);
+    const __m128 dv1 = _mm_setr_ps(dv.y, dv.z, dv.x, dv.y);
+    const __m128 dv2 = _mm_setr_ps(dv.z, dv.x, dv.y, dv.z);
+    const __m128 t = _mm_set1_ps(dt);
+
+    float* p = &positions[0].x;
+    float* v = &velocities[0].x;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 12, v += 12) {
+        __m128 v0 = _mm_add_ps(_mm_loadu_ps(v), dv0);
+        __m128 v1 = _mm_add_ps(_mm_loadu_ps(v + 4), dv1);
+        __m128 v2 = _mm_add_ps(_mm_loadu_ps(v + 8), dv2);
+        _mm_storeu_ps(v, v0);
+        _mm_storeu_ps(v + 4, v1);
+        _mm_storeu_ps(v + 8, v2);
+        _mm_storeu_ps(p, _mm_add_ps(_mm_loadu_ps(p), _mm_mul_ps(v0, t)));
+        _mm_storeu_ps(p + 4, _mm_add_ps(_mm_loadu_ps(p + 4), _mm_mul_ps(v1, t)));
+        _mm_storeu_ps(p + 8, _mm_add_ps(_mm_loadu_ps(p + 8), _mm_mul_ps(v2, t)));
+    }
+    integrateScalar(positions + i, velocities + i, count - i, acceleration, dt);
+}
+
+// ---- AVX2: 8 floats, or 8 particles as three registers ----
+
+ENGINE_TARGET_AVX2
+void addAVX2(float* data, size_t count, float value) {
+    const __m256 v = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), v));
+    }
+    addScalar(data + i, count - i, value);
+}
+
+ENGINE_TARGET_AVX2
+void scaleAVX2(float* data, size_t count, float factor) {
+    const __m256 f = _mm256_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), f));
+    }
+    scaleScalar(data + i, count - i, factor);
+}
+
+ENGINE_TARGET_AVX2
+void integrateAVX2(glm::vec3* positions, glm::vec3* velocities, size_t count,
+                   const glm::vec3& acceleration, float dt) {
+    glm::vec3 dv = acceleration * dt;
+    const __m256 dv0 = _mm256_setr_ps(dv.x, dv.y, dv.z, dv.x, dv.y, dv.z, dv.x, dv.y);
+    const __m256 dv1 = _mm256_setr_ps(dv.z, dv.x, dv.y, dv.z, dv.x, dv.y, dv.z, dv.x);
+    const __m256 dv2 = _mm256_setr_ps(dv.y, dv.z, dv.x, dv.y, dv.z, dv.x, dv.y, dv.z);
+    const __m256 t = _mm256_set1_ps(dt);
+
+    float* p = &positions[0].x;
+    float* v = &velocities[0].x;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, p += 24, v += 24) {
+        __m256 v0 = _mm256_add_ps(_mm256_loadu_ps(v), dv0);
+        __m256 v1 = _mm256_add_ps(_mm256_loadu_ps(v + 8), dv1);
+        __m256 v2 = _mm256_add_ps(_mm256_loadu_ps(v + 16), dv2);
+        _mm256_storeu_ps(v, v0);
+        _mm256_storeu_ps(v + 8, v1);
+        _mm256_storeu_ps(v + 16, v2);
+        _mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_mul_ps(v0, t)));
+        _mm256_storeu_ps(p + 8, _mm256_add_ps(_mm256_loadu_ps(p + 8), _mm256_mul_ps(v1, t)));
+        _mm256_storeu_ps(p + 16, _mm256_add_ps(_mm256_loadu_ps(p + 16), _mm256_mul_ps(v2, t)));
+    }
+    integrateScalar(positions + i, velocities + i, count - i, acceleration, dt);
+}
+
+#endif
+
+const SimdKernels kScalarKernels = { SimdLevel::SCALAR, addScalar, scaleScalar, integrateScalar };
+#ifdef ENGINE_X86_SIMD
+const SimdKernels kSSE2Kernels = { SimdLevel::SSE2, addSSE2, scaleSSE2, integrateSSE2 };
+const SimdKernels kAVX2Kernels = { SimdLevel::AVX2, addAVX2, scaleAVX2, integrateAVX2 };
+#endif
+
+} // namespace
+
+const SimdKernels* SimdKernels::forLevel(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR:
+            return &kScalarKernels;
+#ifdef ENGINE_X86_SIMD
+        case SimdLevel::SSE2:
+            return CpuFeatures::get().sse2 ? &kSSE2Kernels : nullptr;
+        case SimdLevel::AVX2:
+            return CpuFeatures::get().avx2 ? &kAVX2Kernels : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const SimdKernels& SimdKernels::get() {
+    static const SimdKernels& kernels = []() -> const SimdKernels& {
+        if (const SimdKernels* k = forLevel(SimdLevel::AVX2)) return *k;
+        if (const SimdKernels* k = forLevel(SimdLevel::SSE2)) return *k;
+        return kScalarKernels;
+    }();
+    return kernels;
+}
+
+} // namespace Engine
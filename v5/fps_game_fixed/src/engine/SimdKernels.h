@@ -0,0 +1,38 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+namespace Engine {
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+const char* simdLevelName(SimdLevel level);
+
+// Bulk float kernels for SoA data. Every instruction set gets the same
+// table; get() picks the widest one the CPU supports, once, on first use.
+// vec3 arrays are treated as tightly packed xyz floats.
+struct SimdKernels {
+    SimdLevel level;
+
+    // data[i] += value
+    void (*add)(float* data, size_t count, float value);
+    // data[i] *= factor
+    void (*scale)(float* data, size_t count, float factor);
+    // velocity += acceleration * dt, then position += velocity * dt
+    void (*integrate)(glm::vec3* positions, glm::vec3* velocities, size_t count,
+                      const glm::vec3& acceleration, float dt);
+
+    static const SimdKernels& get();
+    // Kernels for a specific level, or nullptr if this CPU or build lacks it
+    static const SimdKernels* forLevel(SimdLevel level);
+};
+
+} // namespace Engine
+
+#endif // SIMD_KERNELS_H
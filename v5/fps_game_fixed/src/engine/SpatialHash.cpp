@@ -0,0 +1,196 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <limits>
+
+namespace Engine {
+
+SpatialHash::SpatialHash(float cellSize)
+    : m_cellSize(cellSize)
+    , m_count(0)
+{
+}
+
+void SpatialHash::clear() {
+    m_entries.clear();
+    m_cells.clear();
+    m_count = 0;
+}
+
+void SpatialHash::insert(uint32_t id, const glm::vec3& position) {
+    if (id >= m_entries.size()) {
+        m_entries.resize(id + 1, Entry{0, 0, false, glm::vec3(0.0f)});
+    }
+    if (m_entries[id].present) {
+        update(id, position);
+        return;
+    }
+
+    m_entries[id].present = true;
+    m_entries[id].position = position;
+    addToCell(id, cellKey(cellCoord(position.x), cellCoord(position.z)));
+    m_count++;
+}
+
+bool SpatialHash::update(uint32_t id, const glm::vec3& position) {
+    Entry& entry = m_entries[id];
+    entry.position = position;
+
+    int64_t cell = cellKey(cellCoord(position.x), cellCoord(position.z));
+    if (cell == entry.cell) return false;
+
+    removeFromCell(id);
+    addToCell(id, cell);
+    return true;
+}
+
+void SpatialHash::remove(uint32_t id) {
+    if (!contains(id)) return;
+
+    removeFromCell(id);
+    m_entries[id].present = false;
+    m_count--;
+}
+
+void SpatialHash::rename(uint32_t from, uint32_t to) {
+    if (!contains(from) || from == to) return;
+    if (to >= m_entries.size()) {
+        m_entries.resize(to + 1, Entry{0, 0, false, glm::vec3(0.0f)});
+    }
+
+    Entry& entry = m_entries[from];
+    m_cells[entry.cell][entry.slot] = to;
+    m_entries[to] = entry;
+    entry.present = false;
+}
+
+const std::vector<uint32_t>* SpatialHash::findCell(int x, int z) const {
+    auto it = m_cells.find(cellKey(x, z));
+    if (it == m_cells.end() || it->second.empty()) return nullptr;
+    return &it->second;
+}
+
+void SpatialHash::addToCell(uint32_t id, int64_t cell) {
+    std::vector<uint32_t>& ids = m_cells[cell];
+    m_entries[id].cell = cell;
+    m_entries[id].slot = static_cast<uint32_t>(ids.size());
+    ids.push_back(id);
+}
+
+void SpatialHash::removeFromCell(uint32_t id) {
+    // Swap-remove; the moved id learns its new slot
+    const Entry& entry = m_entries[id];
+    std::vector<uint32_t>& ids = m_cells[entry.cell];
+    uint32_t last = ids.back();
+    ids[entry.slot] = last;
+    m_entries[last].slot = entry.slot;
+    ids.pop_back();
+}
+
+void SpatialHash::queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const {
+    int minX = cellCoord(center.x - radius), maxX = cellCoord(center.x + radius);
+    int minZ = cellCoord(center.z - radius), maxZ = cellCoord(center.z + radius);
+    float radiusSq = radius * radius;
+
+    for (int x = minX; x <= maxX; ++x) {
+        for (int z = minZ; z <= maxZ; ++z) {
+            const std::vector<uint32_t>* cell = findCell(x, z);
+            if (!cell) continue;
+
+            for (uint32_t id : *cell) {
+                glm::vec3 d = m_entries[id].position - center;
+                if (glm::dot(d, d) < radiusSq) {
+                    out.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::queryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& out) const {
+    int minX = cellCoord(min.x), maxX = cellCoord(max.x);
+    int minZ = cellCoord(min.z), maxZ = cellCoord(max.z);
+
+    for (int x = minX; x <= maxX; ++x) {
+        for (int z = minZ; z <= maxZ; ++z) {
+            const std::vector<uint32_t>* cell = findCell(x, z);
+            if (!cell) continue;
+
+            for (uint32_t id : *cell) {
+                const glm::vec3& p = m_entries[id].position;
+                if (p.x >= min.x && p.x <= max.x &&
+                    p.y >= min.y && p.y <= max.y &&
+                    p.z >= min.z && p.z <= max.z) {
+                    out.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                           float radius, std::vector<uint32_t>& out) const {
+    glm::vec3 dir = glm::normalize(direction);
+    glm::vec3 end = origin + dir * maxDistance;
+    float radiusSq = radius * radius;
+
+    // Cells within 'reach' of a walked cell can hold ids inside the radius
+    int reach = static_cast<int>(std::ceil(radius / m_cellSize));
+
+    auto scanCells = [&](int x0, int x1, int z0, int z1) {
+        for (int x = x0; x <= x1; ++x) {
+            for (int z = z0; z <= z1; ++z) {
+                const std::vector<uint32_t>* cell = findCell(x, z);
+                if (!cell) continue;
+
+                for (uint32_t id : *cell) {
+                    glm::vec3 toPoint = m_entries[id].position - origin;
+                    float t = std::max(0.0f, std::min(maxDistance, glm::dot(toPoint, dir)));
+                    glm::vec3 d = toPoint - dir * t;
+                    if (glm::dot(d, d) <= radiusSq) {
+                        out.push_back(id);
+                    }
+                }
+            }
+        }
+    };
+
+    // 2D DDA over the XZ projection of the segment
+    const float inf = std::numeric_limits<float>::infinity();
+    int cx = cellCoord(origin.x), cz = cellCoord(origin.z);
+    int endX = cellCoord(end.x), endZ = cellCoord(end.z);
+    int stepX = dir.x > 0.0f ? 1 : -1;
+    int stepZ = dir.z > 0.0f ? 1 : -1;
+
+    float tMaxX = inf, tMaxZ = inf, tDeltaX = inf, tDeltaZ = inf;
+    if (dir.x != 0.0f) {
+        float border = (cx + (stepX > 0 ? 1 : 0)) * m_cellSize;
+        tMaxX = (border - origin.x) / dir.x;
+        tDeltaX = m_cellSize / std::fabs(dir.x);
+    }
+    if (dir.z != 0.0f) {
+        float border = (cz + (stepZ > 0 ? 1 : 0)) * m_cellSize;
+        tMaxZ = (border - origin.z) / dir.z;
+        tDeltaZ = m_cellSize / std::fabs(dir.z);
+    }
+
+    // The walk only ever moves forward along x and z, so each step adds
+    // exactly one new column or row to the scanned area: its leading edge.
+    // No cell is visited twice and nothing needs remembering.
+    int steps = std::abs(endX - cx) + std::abs(endZ - cz);
+    scanCells(cx - reach, cx + reach, cz - reach, cz + reach);
+    for (int i = 0; i < steps; ++i) {
+        if (tMaxX < tMaxZ) {
+            cx += stepX;
+            tMaxX += tDeltaX;
+            int x = cx + stepX * reach;
+            scanCells(x, x, cz - reach, cz + reach);
+        } else {
+            cz += stepZ;
+            tMaxZ += tDeltaZ;
+            int z = cz + stepZ * reach;
+            scanCells(cx - reach, cx + reach, z, z);
+        }
+    }
+}
+
+} // namespace Engine
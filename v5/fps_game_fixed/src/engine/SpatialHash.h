@@ -0,0 +1,129 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+
+// Uniform grid over the XZ plane for point entities with small dense ids.
+// Each cell keeps the ids inside it; an entity only changes cells when it
+// crosses a cell border, so moving one is usually a compare and a store.
+// Queries touch the cells around the query shape, which keeps their cost
+// tied to local density rather than the total entity count.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 2.0f);
+
+    void clear();
+    void insert(uint32_t id, const glm::vec3& position);
+    // Returns true if the entity moved into a different cell
+    bool update(uint32_t id, const glm::vec3& position);
+    void remove(uint32_t id);
+    // Re-labels 'from' as 'to', for owners that swap-remove their arrays
+    void rename(uint32_t from, uint32_t to);
+
+    bool contains(uint32_t id) const { return id < m_entries.size() && m_entries[id].present; }
+    size_t size() const { return m_count; }
+    float getCellSize() const { return m_cellSize; }
+
+    // Ids strictly within 'radius' of 'center'
+    void queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+    // Ids whose position lies inside the box
+    void queryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& out) const;
+    // Ids within 'radius' of the segment origin + dir * [0, maxDistance],
+    // found by walking the cells under the ray
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                  float radius, std::vector<uint32_t>& out) const;
+
+    // Closest id within 'maxRange' that 'accept' returns true for; searches
+    // rings of cells outward and stops once no closer id can exist
+    template <typename Accept>
+    bool queryNearest(const glm::vec3& center, float maxRange, Accept accept, uint32_t& outId) const;
+
+private:
+    struct Entry {
+        int64_t cell;
+        uint32_t slot;
+        bool present;
+        glm::vec3 position;
+    };
+
+    int cellCoord(float v) const { return static_cast<int>(std::floor(v / m_cellSize)); }
+    static int64_t cellKey(int x, int z) {
+        uint64_t hi = static_cast<uint32_t>(x);
+        return static_cast<int64_t>((hi << 32) | static_cast<uint32_t>(z));
+    }
+
+    const std::vector<uint32_t>* findCell(int x, int z) const;
+    void addToCell(uint32_t id, int64_t cell);
+    void removeFromCell(uint32_t id);
+
+    float m_cellSize;
+    size_t m_count;
+    std::vector<Entry> m_entries;
+    std::unordered_map<int64_t, std::vector<uint32_t>> m_cells;
+};
+
+template <typename Accept>
+bool SpatialHash::queryNearest(const glm::vec3& center, float maxRange, Accept accept,
+                               uint32_t& outId) const {
+    int cx = cellCoord(center.x);
+    int cz = cellCoord(center.z);
+    int maxRing = static_cast<int>(std::ceil(maxRange / m_cellSize)) + 1;
+
+    bool found = false;
+    float bestDistance = maxRange;
+    size_t cellsVisited = 0;
+
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        // Sparse grid: once the rings cost more lookups than there are
+        // entities, finish with a straight scan instead
+        cellsVisited += ring == 0 ? 1 : 8 * ring;
+        if (cellsVisited > m_count + 8) {
+            for (uint32_t id = 0; id < m_entries.size(); ++id) {
+                if (!m_entries[id].present) continue;
+
+                float distance = glm::length(m_entries[id].position - center);
+                if (distance < bestDistance && accept(id)) {
+                    found = true;
+                    bestDistance = distance;
+                    outId = id;
+                }
+            }
+            break;
+        }
+
+        for (int x = cx - ring; x <= cx + ring; ++x) {
+            for (int z = cz - ring; z <= cz + ring; ++z) {
+                // Only the border of the square; the inside was done already
+                if (x != cx - ring && x != cx + ring && z != cz - ring && z != cz + ring) continue;
+
+                const std::vector<uint32_t>* cell = findCell(x, z);
+                if (!cell) continue;
+
+                for (uint32_t id : *cell) {
+                    float distance = glm::length(m_entries[id].position - center);
+                    if (distance < bestDistance && accept(id)) {
+                        found = true;
+                        bestDistance = distance;
+                        outId = id;
+                    }
+                }
+            }
+        }
+
+        // Anything in the next ring is at least this far away
+        if (found && bestDistance <= ring * m_cellSize) break;
+    }
+
+    return found;
+}
+
+} // namespace Engine
+
+#endif // SPATIAL_HASH_H
@@ -1,4 +1,10 @@
 #include "Texture.h"
+#include <SDL2/SDL.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 
 namespace Engine {
@@ -12,10 +18,29 @@ Texture::~Texture() {
     }
 }
 
-bool Texture::loadFromFile(const std::string& /*path*/) {
-    // Placeholder - creates a simple procedural texture
-    glGenTextures(1, &m_textureID);
+void Texture::create() {
+    if (!m_textureID) {
+        glGenTextures(1, &m_textureID);
+    }
     glBindTexture(GL_TEXTURE_2D, m_textureID);
+}
+
+bool Texture::loadFromFile(const std::string& path) {
+    TextureImage image;
+    if (!decodeFile(path, image)) {
+        return false;
+    }
+    buildMips(image);
+
+    for (int level = 0; level < image.getLevelCount(); ++level) {
+        uploadLevel(level, image.getLevelWidth(level), image.getLevelHeight(level), image.levels[level].data());
+    }
+    setLevelRange(0, image.getLevelCount() - 1);
+    return true;
+}
+
+void Texture::createPlaceholder() {
+    create();
 
     // Create a simple 2x2 checkerboard pattern
     unsigned char data[] = {
@@ -29,8 +54,121 @@ bool Texture::loadFromFile(const std::string& /*path*/) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+}
 
-    return true;
+void Texture::uploadLevel(int level, int width, int height, const void* pixels) {
+    create();
+    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+void Texture::setLevelRange(int base, int max) {
+    create();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, base);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, max);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+namespace {
+
+// Fallback for BMPs when stb_image is the minimal build; takes ownership
+// of 'source'
+bool decodeBmp(SDL_RWops* source, const std::string& name, TextureImage& image) {
+    SDL_Surface* loaded = source ? SDL_LoadBMP_RW(source, 1) : nullptr;
+    if (!loaded) {
+        std::cerr << "Failed to load texture " << name << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) {
+        std::cerr << "Failed to convert texture " << name << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    image.width = rgba->w;
+    image.height = rgba->h;
+    image.levels.assign(1, std::vector<uint8_t>(static_cast<size_t>(rgba->w) * rgba->h * 4));
+
+    // Surfaces may pad their rows
+    size_t rowBytes = static_cast<size_t>(rgba->w) * 4;
+    const uint8_t* src = static_cast<const uint8_t*>(rgba->pixels);
+    for (int y = 0; y < rgba->h; ++y) {
+        std::memcpy(&image.levels[0][y * rowBytes], src + static_cast<size_t>(y) * rgba->pitch, rowBytes);
+    }
+    SDL_FreeSurface(rgba);
+    return image.width > 0 && image.height > 0;
+}
+
+} // namespace
+
+bool Texture::decodeFile(const std::string& path, TextureImage& image) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Failed to open texture " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size())) {
+        std::cerr << "Failed to read texture " << path << std::endl;
+        return false;
+    }
+    return decodeMemory(data.data(), data.size(), path, image);
+}
+
+bool Texture::decodeMemory(const void* data, size_t size, const std::string& name, TextureImage& image) {
+    if (size > static_cast<size_t>(INT_MAX)) {
+        std::cerr << "Texture " << name << " is too large" << std::endl;
+        return false;
+    }
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(static_cast<const stbi_uc*>(data), static_cast<int>(size),
+                                            &width, &height, &channels, 4);
+    if (!pixels) {
+        return decodeBmp(SDL_RWFromConstMem(data, static_cast<int>(size)), name, image);
+    }
+
+    // Rows come out top first with no padding, as GL expects them here
+    image.width = width;
+    image.height = height;
+    image.levels.assign(1, std::vector<uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * 4));
+    stbi_image_free(pixels);
+    return width > 0 && height > 0;
+}
+
+void Texture::buildMips(TextureImage& image) {
+    image.levels.resize(1);
+    int width = image.width, height = image.height;
+    while (width > 1 || height > 1) {
+        int dw = width > 1 ? width / 2 : 1;
+        int dh = height > 1 ? height / 2 : 1;
+        const std::vector<uint8_t>& src = image.levels.back();
+        std::vector<uint8_t> dst(static_cast<size_t>(dw) * dh * 4);
+
+        for (int y = 0; y < dh; ++y) {
+            // Odd sizes drop their last row/column rather than read past it
+            int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+            for (int x = 0; x < dw; ++x) {
+                int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+                for (int c = 0; c < 4; ++c) {
+                    int sum = src[(static_cast<size_t>(y0) * width + x0) * 4 + c] +
+                              src[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+                              src[(static_cast<size_t>(y1) * width + x0) * 4 + c] +
+                              src[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                    dst[(static_cast<size_t>(y) * dw + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        image.levels.push_back(std::move(dst));
+        width = dw;
+        height = dh;
+    }
 }
 
 void Texture::bind(unsigned int unit) {
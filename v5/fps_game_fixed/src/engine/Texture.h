@@ -2,22 +2,60 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace Engine {
 
+// Decoded RGBA8 pixels with the full mip chain, level 0 first
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<uint8_t>> levels;
+
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    int getLevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int getLevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+};
+
 class Texture {
 public:
     Texture();
     ~Texture();
 
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    // Decodes and uploads on the calling thread; TextureStreamer does the
+    // same off the render thread
     bool loadFromFile(const std::string& path);
+    // 2x2 grey checkerboard, drawn until real pixels arrive
+    void createPlaceholder();
+    // Defines one mip level. 'pixels' is an offset into the bound
+    // GL_PIXEL_UNPACK_BUFFER when one is bound.
+    void uploadLevel(int level, int width, int height, const void* pixels);
+    // Samples only levels [base, max], so a chain streamed in coarsest
+    // first is complete after every upload
+    void setLevelRange(int base, int max);
+
     void bind(unsigned int unit = 0);
     void unbind();
 
     GLuint getID() const { return m_textureID; }
 
+    // Thread-safe; no GL. PNG, JPEG, TGA and BMP through stb_image, with
+    // SDL's loader as a fallback for BMP.
+    static bool decodeFile(const std::string& path, TextureImage& image);
+    // Same, from a file already in memory (e.g. an asset pack mapping);
+    // 'name' is only for error messages
+    static bool decodeMemory(const void* data, size_t size, const std::string& name, TextureImage& image);
+    // Fills levels 1..n from level 0 with a 2x2 box filter
+    static void buildMips(TextureImage& image);
+
 private:
+    void create();
+
     GLuint m_textureID;
 };
 
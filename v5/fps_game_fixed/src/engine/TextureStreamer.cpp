@@ -0,0 +1,141 @@
+#include "TextureStreamer.h"
+#include <cstring>
+#include <iostream>
+
+namespace Engine {
+
+TextureStreamer::TextureStreamer(int decodeThreads)
+    : m_pack(nullptr)
+    , m_cancel(false)
+    , m_pixelBuffers{0, 0, 0}
+    , m_nextBuffer(0)
+    , m_decoders(decodeThreads) {
+}
+
+TextureStreamer::~TextureStreamer() {
+    m_cancel = true;
+    m_decoders.wait(m_inFlight);
+}
+
+TextureHandle TextureStreamer::load(const std::string& path) {
+    auto found = m_textures.find(path);
+    if (found != m_textures.end()) {
+        if (TextureHandle texture = found->second.lock()) {
+            return texture;
+        }
+    }
+
+    TextureHandle texture = std::make_shared<Texture>();
+    texture->createPlaceholder();
+    m_textures[path] = texture;
+    ++m_stats.requested;
+    ++m_stats.pending;
+
+    auto request = std::make_shared<Request>();
+    request->path = path;
+    request->texture = texture;
+    const AssetPack* pack = m_pack;
+    m_decoders.submit([this, request, pack]() {
+        if (m_cancel) {
+            return;
+        }
+        bool ok;
+        size_t size = 0;
+        std::vector<uint8_t> unpacked;
+        if (const uint8_t* mapped = pack ? pack->find(request->path, size) : nullptr) {
+            ok = Texture::decodeMemory(mapped, size, request->path, request->image);
+        } else if (pack && pack->read(request->path, unpacked)) {
+            ok = Texture::decodeMemory(unpacked.data(), unpacked.size(), request->path, request->image);
+        } else {
+            ok = Texture::decodeFile(request->path, request->image);
+        }
+        if (ok) {
+            Texture::buildMips(request->image);
+            request->nextLevel = request->image.getLevelCount() - 1;
+        }
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_decoded.push_back({request, ok});
+    }, &m_inFlight);
+    return texture;
+}
+
+void TextureStreamer::update(size_t budgetBytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        for (Decoded& decoded : m_decoded) {
+            if (decoded.ok) {
+                m_uploads.push_back(std::move(decoded.request));
+            } else {
+                --m_stats.pending;
+                ++m_stats.failed;
+            }
+        }
+        m_decoded.clear();
+    }
+
+    size_t spent = 0;
+    while (!m_uploads.empty() && (spent == 0 || spent < budgetBytes)) {
+        if (!uploadLevel(*m_uploads.front(), spent)) {
+            m_uploads.pop_front();
+            --m_stats.pending;
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+bool TextureStreamer::uploadLevel(Request& request, size_t& spent) {
+    TextureHandle texture = request.texture.lock();
+    if (!texture) {
+        return false; // nobody is drawing it any more
+    }
+
+    if (!m_pixelBuffers[0]) {
+        glGenBuffers(3, m_pixelBuffers);
+    }
+
+    int level = request.nextLevel;
+    const std::vector<uint8_t>& pixels = request.image.levels[level];
+
+    // Rotate through a few buffers so the driver can still be reading the
+    // last one; orphaning keeps the map from waiting on it either way
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffers[m_nextBuffer]);
+    m_nextBuffer = (m_nextBuffer + 1) % 3;
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, pixels.size(), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, pixels.size(),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        std::cerr << "Failed to map upload buffer for " << request.path << std::endl;
+        ++m_stats.failed;
+        return false;
+    }
+    std::memcpy(mapped, pixels.data(), pixels.size());
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    texture->uploadLevel(level, request.image.getLevelWidth(level), request.image.getLevelHeight(level), nullptr);
+    texture->setLevelRange(level, request.image.getLevelCount() - 1);
+    spent += pixels.size();
+    m_stats.uploadedBytes += pixels.size();
+
+    // Free each level once it is on the GPU
+    std::vector<uint8_t>().swap(request.image.levels[level]);
+    if (--request.nextLevel < 0) {
+        ++m_stats.resident;
+        return false;
+    }
+    return true;
+}
+
+void TextureStreamer::shutdown() {
+    m_cancel = true;
+    m_decoders.wait(m_inFlight);
+    m_decoded.clear();
+    m_uploads.clear();
+    m_stats.pending = 0;
+
+    if (m_pixelBuffers[0]) {
+        glDeleteBuffers(3, m_pixelBuffers);
+        m_pixelBuffers[0] = m_pixelBuffers[1] = m_pixelBuffers[2] = 0;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,86 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include "Texture.h"
+#include <glad/glad.h>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+using TextureHandle = std::shared_ptr<Texture>;
+
+struct TextureStreamerStats {
+    size_t requested = 0;     // distinct files asked for
+    size_t resident = 0;      // fully uploaded
+    size_t failed = 0;        // kept their placeholder
+    size_t pending = 0;       // decoding or waiting for upload budget
+    size_t uploadedBytes = 0; // over the streamer's lifetime
+};
+
+// Loads textures without stalling the frame. load() hands back a
+// placeholder at once; the file is decoded and its mips built on a small
+// pool of decode threads, and update() uploads the result through pixel
+// buffer objects a few mip levels per frame, coarsest first, into the same
+// GL texture the caller is already drawing with.
+// load() and update() belong to the render thread.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(int decodeThreads = 2);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Paths found in the pack are decoded straight from its mapping;
+    // anything else is read from disk. The pack must stay open until
+    // shutdown().
+    void setAssetPack(const AssetPack* pack) { m_pack = pack; }
+    // Files already requested share one texture
+    TextureHandle load(const std::string& path);
+    // Uploads decoded levels until 'budgetBytes' is spent (at least one
+    // level per call so large mips still land)
+    void update(size_t budgetBytes);
+    // Drops pending work and the GL buffers; needs the context
+    void shutdown();
+
+    const TextureStreamerStats& getStats() const { return m_stats; }
+
+private:
+    struct Request {
+        std::string path;
+        std::weak_ptr<Texture> texture;
+        TextureImage image;
+        int nextLevel = 0; // counts down from the coarsest level
+    };
+
+    struct Decoded {
+        std::shared_ptr<Request> request;
+        bool ok;
+    };
+
+    bool uploadLevel(Request& request, size_t& spent);
+
+    const AssetPack* m_pack;
+    std::map<std::string, std::weak_ptr<Texture>> m_textures;
+    std::mutex m_decodedMutex;
+    std::vector<Decoded> m_decoded;
+    std::deque<std::shared_ptr<Request>> m_uploads;
+    std::atomic<bool> m_cancel;
+    JobCounter m_inFlight;
+    GLuint m_pixelBuffers[3];
+    unsigned m_nextBuffer;
+    TextureStreamerStats m_stats;
+    JobSystem m_decoders; // last: its workers join before the rest goes away
+};
+
+} // namespace Engine
+
+#endif // TEXTURE_STREAMER_H
@@ -1,4 +1,5 @@
 #include "Window.h"
+#include "Keys.h"
 #include <iostream>
 
 namespace Engine {
@@ -103,7 +104,7 @@ void Window::processEvents() {
             case SDL_MOUSEBUTTONDOWN:
             case SDL_MOUSEBUTTONUP:
                 if (m_keyCallback && event.button.button == SDL_BUTTON_LEFT) {
-                    m_keyCallback(1000, event.type == SDL_MOUSEBUTTONDOWN);
+                    m_keyCallback(Key::MOUSE_LEFT, event.type == SDL_MOUSEBUTTONDOWN);
                 }
                 break;
         }
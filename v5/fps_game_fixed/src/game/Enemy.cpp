@@ -1,97 +1,188 @@
 #include "Enemy.h"
-#include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
 
 namespace Game {
 
-Enemy::Enemy(const glm::vec3& position)
-    : m_mesh(Engine::Mesh::createCube(glm::vec3(1.0f, 0.2f, 0.2f)))
-    , m_position(position)
-    , m_velocity(0.0f)
-    , m_health(100.0f)
-    , m_maxHealth(100.0f)
-    , m_speed(2.0f)
-    , m_detectionRange(15.0f)
-    , m_active(false)
-    , m_damageFlashTimer(0.0f)
-{
+EnemyStore::EnemyStore() : m_grid(kGridCellSize) {
 }
 
-Enemy::~Enemy() {
+EnemyStore::~EnemyStore() {
 }
 
-void Enemy::update(float deltaTime, const glm::vec3& playerPos) {
-    if (!isAlive()) return;
+size_t EnemyStore::spawn(const glm::vec3& position) {
+    m_positions.push_back(position);
+    m_prevPositions.push_back(position);
+    m_velocities.push_back(glm::vec3(0.0f));
+    m_health.push_back(kMaxHealth);
+    m_damageFlashTimers.push_back(0.0f);
+    m_active.push_back(0);
+    m_wallSide.push_back(0);
+    m_lodLevels.push_back(0);
     
-    // Update damage flash
-    if (m_damageFlashTimer > 0.0f) {
-        m_damageFlashTimer -= deltaTime;
+    size_t index = m_positions.size() - 1;
+    m_grid.insert(static_cast<uint32_t>(index), position);
+    return index;
+}
+
+void EnemyStore::removeAt(size_t index) {
+    size_t last = m_positions.size() - 1;
+    m_grid.remove(static_cast<uint32_t>(index));
+    if (index != last) {
+        m_grid.rename(static_cast<uint32_t>(last), static_cast<uint32_t>(index));
+        m_positions[index] = m_positions[last];
+        m_prevPositions[index] = m_prevPositions[last];
+        m_velocities[index] = m_velocities[last];
+        m_health[index] = m_health[last];
+        m_damageFlashTimers[index] = m_damageFlashTimers[last];
+        m_active[index] = m_active[last];
+        m_wallSide[index] = m_wallSide[last];
+        m_lodLevels[index] = m_lodLevels[last];
     }
-    
-    // Check if player is in range
-    float distance = glm::length(playerPos - m_position);
-    
-    if (distance < m_detectionRange) {
-        m_active = true;
-        
-        // Move towards player
-        glm::vec3 direction = glm::normalize(playerPos - m_position);
-        direction.y = 0.0f; // Keep on ground plane
-        
-        if (distance > 2.0f) { // Stop at close range
-            m_velocity = direction * m_speed;
+
+    m_positions.pop_back();
+    m_prevPositions.pop_back();
+    m_velocities.pop_back();
+    m_health.pop_back();
+    m_damageFlashTimers.pop_back();
+    m_active.pop_back();
+    m_wallSide.pop_back();
+    m_lodLevels.pop_back();
+}
+
+void EnemyStore::clear() {
+    m_positions.clear();
+    m_prevPositions.clear();
+    m_velocities.clear();
+    m_health.clear();
+    m_damageFlashTimers.clear();
+    m_active.clear();
+    m_wallSide.clear();
+    m_lodLevels.clear();
+    m_grid.clear();
+}
+
+void EnemyStore::reserve(size_t count) {
+    m_positions.reserve(count);
+    m_prevPositions.reserve(count);
+    m_velocities.reserve(count);
+    m_health.reserve(count);
+    m_damageFlashTimers.reserve(count);
+    m_active.reserve(count);
+    m_wallSide.reserve(count);
+    m_lodLevels.reserve(count);
+}
+
+void EnemyStore::update(size_t begin, size_t end, float deltaTime, const glm::vec3& playerPos,
+                        const Engine::CharacterController& controller) {
+    Engine::CharacterShape shape;
+    shape.radius = kRadius;
+    shape.height = kHalfHeight * 2.0f;
+    shape.stepHeight = 0.3f;
+
+    for (size_t i = begin; i < end; ++i) {
+        if (m_health[i] <= 0.0f) continue;
+
+        glm::vec3& position = m_positions[i];
+        glm::vec3& velocity = m_velocities[i];
+
+        m_prevPositions[i] = position;
+
+        // Update damage flash
+        if (m_damageFlashTimers[i] > 0.0f) {
+            m_damageFlashTimers[i] -= deltaTime;
+        }
+
+        // Check if player is in range
+        float distance = glm::length(playerPos - position);
+
+        if (distance < kDetectionRange) {
+            m_active[i] = 1;
+
+            // Move towards player
+            glm::vec3 direction = glm::normalize(playerPos - position);
+            direction.y = 0.0f; // Keep on ground plane
+
+            // Steer horizontally only, so jumps and falls carry on
+            if (distance > 2.0f) { // Stop at close range
+                velocity.x = direction.x * kSpeed;
+                velocity.z = direction.z * kSpeed;
+            } else {
+                velocity.x = 0.0f;
+                velocity.z = 0.0f;
+            }
         } else {
-            m_velocity = glm::vec3(0.0f);
+            m_active[i] = 0;
+            velocity.x *= 0.95f; // Slow down
+            velocity.z *= 0.95f;
+        }
+
+        // Apply gravity
+        velocity.y -= 20.0f * deltaTime;
+
+        // Update position, sliding along walls
+        glm::vec3 feet = position - glm::vec3(0.0f, kHalfHeight, 0.0f);
+        glm::vec3 step = velocity * deltaTime;
+        Engine::MoveResult result = controller.move(feet, step, shape);
+        bool grounded = result.grounded;
+
+        // Walking straight into a wall leaves nothing to slide along, so
+        // follow the wall, sticking to one side until the way is clear
+        glm::vec3 moved = result.position - feet;
+        float wanted = std::sqrt(step.x * step.x + step.z * step.z);
+        float got = std::sqrt(moved.x * moved.x + moved.z * moved.z);
+        if (result.hitWall && m_active[i] && got < wanted * 0.5f) {
+            glm::vec3 tangent(-result.wallNormal.z, 0.0f, result.wallNormal.x);
+            if (m_wallSide[i] == 0) {
+                float side = glm::dot(tangent, playerPos - position);
+                if (std::fabs(side) < 1e-3f) side = (i & 1) ? 1.0f : -1.0f;
+                m_wallSide[i] = side < 0.0f ? -1 : 1;
+            }
+            tangent *= static_cast<float>(m_wallSide[i]);
+
+            result = controller.move(result.position, tangent * (wanted - got), shape);
+            grounded = grounded || result.grounded;
+        } else if (got >= wanted * 0.5f) {
+            m_wallSide[i] = 0;
+        }
+
+        position = result.position + glm::vec3(0.0f, kHalfHeight, 0.0f);
+
+        if (grounded && velocity.y < 0.0f) {
+            velocity.y = 0.0f;
         }
-    } else {
-        m_active = false;
-        m_velocity *= 0.95f; // Slow down
-    }
-    
-    // Apply gravity
-    m_velocity.y -= 20.0f * deltaTime;
-    
-    // Update position
-    m_position += m_velocity * deltaTime;
-    
-    // Ground collision
-    if (m_position.y < 0.5f) {
-        m_position.y = 0.5f;
-        m_velocity.y = 0.0f;
     }
 }
 
-void Enemy::takeDamage(float damage) {
-    m_health -= damage;
-    m_damageFlashTimer = 0.2f;
-    m_active = true; // Activate on damage
+void EnemyStore::updateSpatialHash() {
+    for (size_t i = 0; i < m_positions.size(); ++i) {
+        m_grid.update(static_cast<uint32_t>(i), m_positions[i]);
+    }
 }
 
-bool Enemy::canSeePlayer(const glm::vec3& playerPos) const {
-    float distance = glm::length(playerPos - m_position);
-    return distance < m_detectionRange;
+void EnemyStore::takeDamage(size_t index, float damage) {
+    m_health[index] -= damage;
+    m_damageFlashTimers[index] = 0.2f;
+    m_active[index] = 1; // Activate on damage
 }
 
-glm::mat4 Enemy::getModelMatrix() const {
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, m_position);
-    model = glm::scale(model, glm::vec3(1.0f));
-    return model;
+bool EnemyStore::canSeePlayer(size_t index, const glm::vec3& playerPos) const {
+    float distance = glm::length(playerPos - m_positions[index]);
+    return distance < kDetectionRange;
 }
 
-glm::vec3 Enemy::getColor() const {
-    if (m_damageFlashTimer > 0.0f) {
+glm::vec3 EnemyStore::getColor(size_t index) const {
+    if (m_damageFlashTimers[index] > 0.0f) {
         return glm::vec3(1.0f, 1.0f, 1.0f); // White flash when damaged
     }
-    
-    if (!isAlive()) {
+
+    if (!isAlive(index)) {
         return glm::vec3(0.3f, 0.3f, 0.3f); // Gray when dead
     }
-    
-    if (m_active) {
+
+    if (m_active[index]) {
         return glm::vec3(1.0f, 0.2f, 0.2f); // Red when active
     }
-    
+
     return glm::vec3(0.8f, 0.4f, 0.1f); // Orange when idle
 }
 
@@ -1,41 +1,81 @@
 #ifndef ENEMY_H
 #define ENEMY_H
 
-#include "../engine/Mesh.h"
+#include "../engine/SpatialHash.h"
+#include "../engine/CharacterController.h"
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace Game {
 
-class Enemy {
+// All enemies, stored as parallel arrays (structure of arrays) so the
+// per-frame loops stream through contiguous memory. Index i refers to the
+// same enemy in every array; removal swaps the last enemy into the hole,
+// so indices are only stable until the next removeAt(). A spatial hash
+// keyed by index answers the proximity and hitscan queries.
+class EnemyStore {
 public:
-    Enemy(const glm::vec3& position);
-    ~Enemy();
-
-    void update(float deltaTime, const glm::vec3& playerPos);
-    void takeDamage(float damage);
-    
-    bool isAlive() const { return m_health > 0.0f; }
-    glm::vec3 getPosition() const { return m_position; }
-    Engine::Mesh& getMesh() { return m_mesh; }
-    
-    glm::mat4 getModelMatrix() const;
-    glm::vec3 getColor() const;
-    
-    float getHealth() const { return m_health; }
-    bool canSeePlayer(const glm::vec3& playerPos) const;
+    EnemyStore();
+    ~EnemyStore();
+
+    size_t spawn(const glm::vec3& position);
+    void removeAt(size_t index);
+    void clear();
+    void reserve(size_t count);
+
+    // Steps enemies [begin, end); ranges may run concurrently
+    void update(size_t begin, size_t end, float deltaTime, const glm::vec3& playerPos,
+                const Engine::CharacterController& controller);
+    void takeDamage(size_t index, float damage);
+    // Re-buckets enemies that crossed a grid cell since the last call;
+    // run it after update() and before querying
+    void updateSpatialHash();
+
+    size_t size() const { return m_positions.size(); }
+    bool empty() const { return m_positions.empty(); }
+
+    bool isAlive(size_t index) const { return m_health[index] > 0.0f; }
+    const glm::vec3& getPosition(size_t index) const { return m_positions[index]; }
+    glm::vec3 getInterpolatedPosition(size_t index, float alpha) const {
+        return glm::mix(m_prevPositions[index], m_positions[index], alpha);
+    }
+    float getHealth(size_t index) const { return m_health[index]; }
+    glm::vec3 getColor(size_t index) const;
+    bool canSeePlayer(size_t index, const glm::vec3& playerPos) const;
+    // Mesh LOD level the enemy was last drawn with, kept for hysteresis
+    int getLodLevel(size_t index) const { return m_lodLevels[index]; }
+    void setLodLevel(size_t index, int level) { m_lodLevels[index] = static_cast<uint8_t>(level); }
+
+    const std::vector<glm::vec3>& getPositions() const { return m_positions; }
+    const std::vector<float>& getHealth() const { return m_health; }
+    const Engine::SpatialHash& getSpatialHash() const { return m_grid; }
+
+    static constexpr float kMaxHealth = 100.0f;
+    static constexpr float kSpeed = 2.0f;
+    static constexpr float kDetectionRange = 15.0f;
+    // Enemies are drawn as 0.5-radius spheres but shots test the unit box
+    // around each one; this is that box's bounding sphere
+    static constexpr float kHitRadius = 0.866f;
+    // Grid cell edge; matches the 2 unit contact range so a contact query
+    // only ever touches a 2x2 or 3x3 block of cells
+    static constexpr float kGridCellSize = 2.0f;
+    // Collision capsule; enemies are 0.5-radius spheres centred half a unit up
+    static constexpr float kRadius = 0.5f;
+    static constexpr float kHalfHeight = 0.5f;
 
 private:
-    Engine::Mesh m_mesh;
-    glm::vec3 m_position;
-    glm::vec3 m_velocity;
-    
-    float m_health;
-    float m_maxHealth;
-    float m_speed;
-    float m_detectionRange;
-    
-    bool m_active;
-    float m_damageFlashTimer;
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::vec3> m_prevPositions;
+    std::vector<glm::vec3> m_velocities;
+    std::vector<float> m_health;
+    std::vector<float> m_damageFlashTimers;
+    std::vector<uint8_t> m_active;
+    // Which way an enemy follows a wall blocking it: -1, +1, or 0 when free
+    std::vector<int8_t> m_wallSide;
+    std::vector<uint8_t> m_lodLevels;
+    Engine::SpatialHash m_grid;
 };
 
 } // namespace Game
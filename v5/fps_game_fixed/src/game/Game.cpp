@@ -1,8 +1,12 @@
 #include "Game.h"
+#include "../engine/Keys.h"
 #include <iostream>
-#include <SDL2/SDL.h>
 #include <cmath>
+#include <ctime>
 #include <algorithm>
+#ifndef FPS_HEADLESS
+#include <thread>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -10,10 +14,30 @@
 
 namespace Game {
 
-Game::Game()
-    : m_window("FPS Game - WASD Move, Mouse Look, LMB Shoot, R Reload", 1280, 720)
+// Items per job for the parallel per-entity loops. Below this the loop
+// just runs on the calling thread.
+static const size_t kEnemyGrain = 256;
+
+Game::Game(const GameConfig& config)
+    :
+#ifndef FPS_HEADLESS
+      m_window("FPS Game - WASD Move, Mouse Look, LMB Shoot, R Reload", 1280, 720),
+      m_renderStatsFrame(0),
+      m_frontSnapshot(0),
+      m_simDeltaTime(0.0f),
+      m_simBusy(false),
+      m_simStopped(false),
+      m_simQuit(false),
+#endif
+      m_controller(m_level.getWallBVH())
+    , m_config(config)
+    , m_jobs(config.workerThreads)
+    , m_accumulator(0.0f)
+    , m_replaying(false)
     , m_initialized(false)
     , m_shooting(false)
+    , m_gameOver(false)
+    , m_simulatedTime(0.0f)
     , m_enemySpawnTimer(0.0f)
     , m_score(0)
     , m_wave(1)
@@ -34,63 +58,315 @@ bool Game::init() {
     std::cout << "  ESC - Quit" << std::endl;
     std::cout << "================" << std::endl;
     
+#ifndef FPS_HEADLESS
     if (!m_window.init()) {
         std::cerr << "Failed to initialize window!" << std::endl;
         return false;
     }
     
+    m_renderer.setShaderCacheDirectory(m_config.shaderCacheDir);
     if (!m_renderer.init()) {
         std::cerr << "Failed to initialize renderer!" << std::endl;
         return false;
     }
     
+    // Keep the window alive with a pulsing loading screen while the
+    // driver compiles shaders in the background
+    while (!m_renderer.isReady() && m_window.isRunning()) {
+        m_window.processEvents();
+        float pulse = 0.5f + 0.5f * std::sin(SDL_GetTicks() * 0.005f);
+        m_renderer.clear(glm::vec3(0.1f, 0.1f, 0.15f) * (0.5f + 0.5f * pulse));
+        m_window.swap();
+    }
+    if (!m_renderer.finishLoading()) {
+        std::cerr << "Failed to build shaders!" << std::endl;
+        return false;
+    }
+    
     m_renderer.setViewport(1280, 720);
-    m_renderer.setCamera(&m_player.getCamera());
     
-    // Setup input callbacks
+    if (!m_config.assetPack.empty()) {
+        if (m_assets.open(m_config.assetPack)) {
+            m_renderer.getTextureStreamer().setAssetPack(&m_assets);
+            std::cout << "Asset pack: " << m_config.assetPack << " (" << m_assets.getEntryCount()
+                      << " entries, " << m_assets.getMappedBytes() / 1024 << " KB mapped)" << std::endl;
+        } else {
+            std::cerr << "Falling back to loose asset files" << std::endl;
+        }
+    }
+    
+    // Queue input; it is applied (and recorded) once per frame in pumpInput
     m_window.setKeyCallback([this](int key, bool pressed) {
-        handleKeyInput(key, pressed);
+        m_pendingInput.push_back(Engine::InputEvent::key(key, pressed));
     });
     
     m_window.setMouseCallback([this](double x, double y) {
-        handleMouseMove(x, y);
+        m_pendingInput.push_back(Engine::InputEvent::mouseMove(
+            static_cast<float>(x), static_cast<float>(y)));
     });
     
     m_window.captureMouse(true);
+#endif
+    
+    // All randomness derives from one seed so a recording can reproduce it
+    uint32_t seed = m_config.seed ? m_config.seed : static_cast<uint32_t>(time(nullptr));
+    
+    if (!m_config.replayPath.empty()) {
+        if (!m_playback.open(m_config.replayPath)) {
+            return false;
+        }
+        seed = m_playback.getHeader().seed;
+        m_config.fixedTimestepHz = m_playback.getHeader().fixedTimestepHz;
+        if (m_config.waveSize != m_playback.getHeader().waveSize) {
+            std::cout << "Using the recording's wave size " << m_playback.getHeader().waveSize
+                      << " instead of " << m_config.waveSize << std::endl;
+        }
+        m_config.waveSize = m_playback.getHeader().waveSize;
+        m_replaying = true;
+        std::cout << "Replaying " << m_config.replayPath << " (seed " << seed << ")" << std::endl;
+    }
+    
+    if (!m_config.recordPath.empty()) {
+        Engine::RecordingHeader header;
+        header.seed = seed;
+        header.fixedTimestepHz = m_config.fixedTimestepHz;
+        header.waveSize = m_config.waveSize;
+        if (!m_recorder.open(m_config.recordPath, header)) {
+            return false;
+        }
+        std::cout << "Recording input to " << m_config.recordPath << " (seed " << seed << ")" << std::endl;
+    }
+    
+    m_particles.setCapacity(static_cast<size_t>(std::max(m_config.maxParticles, 0)));
+    m_particles.seed(seed);
     
     // Initialize game objects
     m_weapon = std::make_unique<Weapon>(WeaponType::RIFLE);
     m_level.generate();
     
+#ifndef FPS_HEADLESS
+    // GL objects are created once here and shared; spawning creates none
+    Engine::MeshCache& meshes = m_renderer.getMeshCache();
+    m_enemyLods = Engine::LodChain::createSphere(meshes, 0.5f, glm::vec3(1.0f, 0.2f, 0.2f));
+    m_weapon->loadMeshes(meshes);
+    m_level.loadMeshes(meshes);
+    m_particles.loadMeshes(meshes);
+    std::cout << "Meshes: " << meshes.getMeshCount() << " (" << meshes.getGpuBytes() / 1024
+              << " KB of vertex and index buffers)" << std::endl;
+#endif
+    
     // Spawn initial enemies
     spawnEnemies();
     
     m_initialized = true;
     std::cout << "Game initialized successfully!" << std::endl;
+    if (m_config.fixedTimestepHz > 0.0f) {
+        std::cout << "Fixed timestep: " << m_config.fixedTimestepHz << " Hz" << std::endl;
+    }
+    std::cout << "Job workers: " << m_jobs.getWorkerCount() << std::endl;
+#ifndef FPS_HEADLESS
+    if (m_config.pipelined) {
+        std::cout << "Pipelined simulation/render threads enabled" << std::endl;
+    }
+#endif
     std::cout << "Wave " << m_wave << " - Fight!" << std::endl;
     
     return true;
 }
 
+#ifdef FPS_HEADLESS
 void Game::run() {
     if (!m_initialized) return;
     
-    while (m_window.isRunning()) {
+    // No frame pacing without a window: step as fast as the CPU allows
+    const float hz = m_config.fixedTimestepHz > 0.0f ? m_config.fixedTimestepHz : 60.0f;
+    const float step = 1.0f / hz;
+    
+    while (!m_gameOver && m_simulatedTime < m_config.maxMatchSeconds) {
+        if (m_replaying) {
+            float deltaTime = 0.0f;
+            if (!pumpInput(deltaTime)) break;
+            advance(deltaTime);
+        } else {
+            driveBot();
+            update(step);
+        }
+    }
+}
+
+void Game::driveBot() {
+    // Stand still, aim at the closest enemy and hold the trigger
+    Engine::Camera& camera = m_player.getCamera();
+    glm::vec3 origin = camera.getPosition();
+    
+    uint32_t nearest = 0;
+    bool found = !m_enemies.empty() && m_enemies.getSpatialHash().queryNearest(origin, 1000.0f,
+        [this](uint32_t i) { return m_enemies.isAlive(i); }, nearest);
+    
+    m_shooting = found;
+    if (!found) return;
+    
+    glm::vec3 target = m_enemies.getPosition(nearest);
+    float bestDistance = glm::length(target - origin);
+    if (bestDistance < 1e-4f) return;
+    
+    glm::vec3 dir = (target - origin) / bestDistance;
+    camera.setYaw(static_cast<float>(std::atan2(dir.z, dir.x) * 180.0 / M_PI));
+    camera.setPitch(static_cast<float>(std::asin(dir.y) * 180.0 / M_PI));
+}
+#else
+void Game::run() {
+    if (!m_initialized) return;
+    
+    // The first frame draws the initial state. The pipelined loop flips to
+    // the back snapshot before its first render, so fill that one there.
+    if (m_config.pipelined) {
+        captureSnapshot(1.0f, m_snapshots[1 - m_frontSnapshot]);
+        runPipelined();
+    } else {
+        captureSnapshot(1.0f, m_snapshots[m_frontSnapshot]);
+        runSerial();
+    }
+}
+
+void Game::runSerial() {
+    RenderSnapshot& snapshot = m_snapshots[m_frontSnapshot];
+    
+    while (m_window.isRunning() && !m_gameOver) {
         m_window.processEvents();
+        m_frameInput.swap(m_pendingInput);
         
         float deltaTime = m_window.getDeltaTime();
-        deltaTime = std::min(deltaTime, 0.1f); // Cap delta time
+        if (!pumpInput(deltaTime)) break;
         
-        update(deltaTime);
-        render();
+        captureSnapshot(advance(deltaTime), snapshot);
+        render(snapshot);
+        
+        m_window.swap();
+    }
+}
+
+void Game::runPipelined() {
+    // Frame N: the main thread polls events and renders the snapshot of
+    // frame N-1 while the simulation thread advances to frame N. Input and
+    // GL stay on the main thread; all game state belongs to the simulation
+    // thread until it hands back a finished snapshot.
+    std::thread simulation(&Game::simulationThread, this);
+    
+    while (m_window.isRunning()) {
+        m_window.processEvents();
+        float deltaTime = m_window.getDeltaTime();
         
+        {
+            std::unique_lock<std::mutex> lock(m_simMutex);
+            m_simCondition.wait(lock, [this] { return !m_simBusy; });
+            if (m_simStopped) break;
+            
+            // The back snapshot is complete; kick off the next frame
+            m_frontSnapshot = 1 - m_frontSnapshot;
+            m_frameInput.swap(m_pendingInput);
+            m_pendingInput.clear();
+            m_simDeltaTime = deltaTime;
+            m_simBusy = true;
+        }
+        m_simCondition.notify_all();
+        
+        render(m_snapshots[m_frontSnapshot]);
         m_window.swap();
     }
+    
+    {
+        std::unique_lock<std::mutex> lock(m_simMutex);
+        m_simCondition.wait(lock, [this] { return !m_simBusy; });
+        m_simQuit = true;
+    }
+    m_simCondition.notify_all();
+    simulation.join();
+}
+
+void Game::simulationThread() {
+    std::unique_lock<std::mutex> lock(m_simMutex);
+    
+    for (;;) {
+        m_simCondition.wait(lock, [this] { return m_simBusy || m_simQuit; });
+        if (m_simQuit) return;
+        
+        float deltaTime = m_simDeltaTime;
+        RenderSnapshot& back = m_snapshots[1 - m_frontSnapshot];
+        lock.unlock();
+        
+        bool running = pumpInput(deltaTime);
+        if (running) {
+            captureSnapshot(advance(deltaTime), back);
+        }
+        
+        lock.lock();
+        if (!running || m_gameOver) {
+            m_simStopped = true;
+        }
+        m_simBusy = false;
+        m_simCondition.notify_all();
+    }
+}
+#endif // FPS_HEADLESS
+
+bool Game::pumpInput(float& deltaTime) {
+    // While replaying, the recording supplies both the frame time and the
+    // events; live input gathered this frame is dropped
+    if (m_replaying) {
+        if (!m_playback.readFrame(deltaTime, m_frameInput)) {
+            std::cout << "Replay finished after " << m_playback.getFrameCount()
+                      << " frames" << std::endl;
+            return false;
+        }
+    }
+    
+    m_recorder.writeFrame(deltaTime, m_frameInput);
+    
+    for (const auto& event : m_frameInput) {
+        if (event.type == Engine::InputEvent::KEY) {
+            handleKeyInput(event.code, event.pressed);
+        } else {
+            handleMouseMove(event.dx, event.dy);
+        }
+    }
+    m_frameInput.clear();
+    
+    return true;
+}
+
+float Game::advance(float deltaTime) {
+    deltaTime = std::min(deltaTime, 0.1f); // Cap delta time
+    
+    if (m_config.fixedTimestepHz <= 0.0f) {
+        update(deltaTime);
+        return 1.0f;
+    }
+    
+    // Run the simulation in whole steps and render in between them
+    const float step = 1.0f / m_config.fixedTimestepHz;
+    m_accumulator += deltaTime;
+    
+    int steps = 0;
+    while (m_accumulator >= step && steps < m_config.maxStepsPerFrame) {
+        update(step);
+        m_accumulator -= step;
+        ++steps;
+    }
+    
+    // Drop the backlog we refused to simulate instead of carrying it over
+    if (steps == m_config.maxStepsPerFrame) {
+        m_accumulator = std::min(m_accumulator, step);
+    }
+    
+    return m_accumulator / step;
 }
 
 void Game::update(float deltaTime) {
+    m_simulatedTime += deltaTime;
+    
     // Update player
-    m_player.update(deltaTime);
+    m_player.update(deltaTime, m_controller);
     
     // Update weapon
     if (m_weapon) {
@@ -101,32 +377,28 @@ void Game::update(float deltaTime) {
         }
     }
     
-    // Update enemies
+    // Update enemies; each range only touches its own slots
     glm::vec3 playerPos = m_player.getPosition();
-    for (auto& enemy : m_enemies) {
-        enemy->update(deltaTime, playerPos);
-    }
-    
-    // Remove dead enemies
-    m_enemies.erase(
-        std::remove_if(m_enemies.begin(), m_enemies.end(),
-            [this](const std::unique_ptr<Enemy>& e) {
-                if (!e->isAlive()) {
-                    m_score += 100;
-                    std::cout << "Enemy destroyed! Score: " << m_score << std::endl;
-                    
-                    // Spawn particles
-                    m_particles.emit(e->getPosition(), glm::vec3(0, 1, 0),
-                                   glm::vec3(1.0f, 0.5f, 0.0f), 20);
-                    return true;
-                }
-                return false;
-            }),
-        m_enemies.end()
-    );
+    m_jobs.parallelFor(m_enemies.size(), kEnemyGrain, [&](size_t begin, size_t end) {
+        m_enemies.update(begin, end, deltaTime, playerPos, m_controller);
+    });
+    m_enemies.updateSpatialHash();
+    
+    // Remove dead enemies (back to front, removal swaps in the last slot)
+    for (size_t i = m_enemies.size(); i-- > 0;) {
+        if (m_enemies.isAlive(i)) continue;
+        
+        m_score += 100;
+        std::cout << "Enemy destroyed! Score: " << m_score << std::endl;
+        
+        // Spawn particles
+        m_particles.emit(m_enemies.getPosition(i), glm::vec3(0, 1, 0),
+                       glm::vec3(1.0f, 0.5f, 0.0f), 20);
+        m_enemies.removeAt(i);
+    }
     
     // Update particles
-    m_particles.update(deltaTime);
+    m_particles.update(deltaTime, m_jobs);
     
     // Spawn new enemies
     m_enemySpawnTimer += deltaTime;
@@ -138,63 +410,123 @@ void Game::update(float deltaTime) {
     }
     
     // Check collisions
-    checkCollisions();
+    checkCollisions(deltaTime);
     
     // Game over check
     if (!m_player.isAlive()) {
         std::cout << "\n=== GAME OVER ===" << std::endl;
         std::cout << "Final Score: " << m_score << std::endl;
         std::cout << "Waves Survived: " << m_wave - 1 << std::endl;
-        m_window.shutdown();
+        m_gameOver = true;
     }
 }
 
-void Game::render() {
+#ifndef FPS_HEADLESS
+void Game::captureSnapshot(float alpha, RenderSnapshot& snapshot) {
+    // Camera is a copy of the player camera placed between the last two
+    // simulation states; alpha is 1 when running with a variable timestep
+    snapshot.camera = m_player.getCamera();
+    snapshot.camera.setPosition(m_player.getInterpolatedPosition(alpha));
+    
+    // LOD levels are picked here rather than in render() because the
+    // hysteresis state lives in EnemyStore, which only this thread touches
+    glm::vec3 eye = snapshot.camera.getPosition();
+    float projectionScale = snapshot.camera.getProjectionMatrix(m_renderer.getAspectRatio())[1][1];
+    
+    snapshot.enemies.clear();
+    snapshot.enemyLodLevels.clear();
+    for (size_t i = 0; i < m_enemies.size(); ++i) {
+        if (m_enemies.isAlive(i)) {
+            glm::vec3 position = m_enemies.getInterpolatedPosition(i, alpha);
+            float screenSize = m_enemyLods.getScreenSize(1.0f, glm::length(position - eye), projectionScale);
+            int level = m_enemyLods.select(screenSize, m_enemies.getLodLevel(i));
+            m_enemies.setLodLevel(i, level);
+            
+            snapshot.enemies.push_back({ position, glm::vec3(1.0f), m_enemies.getColor(i) });
+            snapshot.enemyLodLevels.push_back(static_cast<uint8_t>(level));
+        }
+    }
+    
+    m_particles.snapshot(alpha, snapshot.particles);
+    snapshot.hasWeapon = m_weapon != nullptr;
+}
+
+void Game::render(RenderSnapshot& snapshot) {
+    m_renderer.setCamera(&snapshot.camera);
+    m_renderer.beginFrame();
     m_renderer.clear(glm::vec3(0.2f, 0.3f, 0.4f));
+    m_renderQueue.begin(snapshot.camera.getPosition());
+    float aspect = m_renderer.getAspectRatio();
+    glm::mat4 projection = snapshot.camera.getProjectionMatrix(aspect);
+    m_renderQueue.setFrustum(snapshot.camera.getFrustum(aspect));
+    
+    // Walls hide whatever is behind them; draw them into the CPU depth
+    // buffer before anything is submitted
+    if (m_config.occlusionCulling) {
+        m_occlusion.render(projection * snapshot.camera.getViewMatrix(),
+                           snapshot.camera.getPosition(), m_level.getWallBVH().getBoxes(), m_jobs);
+        m_renderQueue.setOcclusion(&m_occlusion);
+    } else {
+        m_renderQueue.setOcclusion(nullptr);
+    }
     
     // Render level
-    m_level.render(m_renderer);
+    m_level.render(m_renderQueue);
     
     // Render enemies
-    for (auto& enemy : m_enemies) {
-        if (enemy->isAlive()) {
-            m_renderer.renderMesh(enemy->getMesh(), enemy->getModelMatrix(), 
-                                enemy->getColor());
-        }
-    }
+    m_renderQueue.submitLod(Engine::RenderPass::OPAQUE, m_enemyLods, snapshot.enemies.data(),
+                            snapshot.enemies.size(), snapshot.enemyLodLevels.data());
     
     // Render particles
-    m_particles.render(m_renderer);
+    m_particles.render(m_renderQueue, snapshot.particles);
     
     // Render weapon (in front of camera)
-    if (m_weapon) {
-        glm::vec3 camPos = m_player.getCamera().getPosition();
-        glm::vec3 camFront = m_player.getCamera().getFront();
-        glm::vec3 camRight = m_player.getCamera().getRight();
+    if (snapshot.hasWeapon) {
+        glm::vec3 camPos = snapshot.camera.getPosition();
+        glm::vec3 camFront = snapshot.camera.getFront();
+        glm::vec3 camRight = snapshot.camera.getRight();
         
         glm::vec3 weaponPos = camPos + camFront * 0.5f + camRight * 0.3f - 
                              glm::vec3(0, 0.3f, 0);
         
-        glm::mat4 weaponModel = glm::mat4(1.0f);
-        weaponModel = glm::translate(weaponModel, weaponPos);
-        weaponModel = glm::scale(weaponModel, glm::vec3(0.1f, 0.05f, 0.3f));
-        
-        m_renderer.renderMesh(m_weapon->getMesh(), weaponModel, 
-                            glm::vec3(0.2f, 0.2f, 0.2f));
+        RenderInstance weapon = { weaponPos, glm::vec3(0.1f, 0.05f, 0.3f), glm::vec3(0.2f, 0.2f, 0.2f) };
+        m_renderQueue.submit(Engine::RenderPass::OVERLAY, *m_weapon->getMesh(), weapon);
+    }
+    
+    m_renderQueue.sort();
+    m_renderer.execute(m_renderQueue);
+    
+    // Upload after the draws so this frame's work is already queued
+    Engine::TextureStreamer& textures = m_renderer.getTextureStreamer();
+    textures.update(static_cast<size_t>(m_config.textureUploadBudgetKB) * 1024);
+    
+    if (m_config.renderStats && ++m_renderStatsFrame % 300 == 0) {
+        const Engine::RenderQueueStats& stats = m_renderQueue.getStats();
+        std::cout << "Render queue: " << stats.items << " items (" << stats.culled
+                  << " culled, " << stats.occluded << " occluded), " << stats.drawCalls
+                  << " draw calls (" << stats.drawCallsSaved() << " saved), "
+                  << stats.shaderChanges + stats.meshChanges << " state changes ("
+                  << stats.stateChangesSaved() << " saved), " << stats.triangles << " triangles ("
+                  << stats.trianglesSaved << " saved by LOD)" << std::endl;
+        const Engine::TextureStreamerStats& streamed = textures.getStats();
+        std::cout << "Textures: " << streamed.resident << "/" << streamed.requested << " resident, "
+                  << streamed.pending << " pending, " << streamed.failed << " failed, "
+                  << streamed.uploadedBytes / 1024 << " KB uploaded" << std::endl;
     }
 }
+#endif // FPS_HEADLESS
 
 void Game::handleKeyInput(int key, bool pressed) {
     m_player.processInput(key, pressed);
     
     if (pressed) {
-        if (key == SDL_SCANCODE_R && m_weapon) {
+        if (key == Engine::Key::R && m_weapon) {
             m_weapon->reload();
         }
     }
     
-    // Handle mouse button (keycode 1000 = left mouse button)
-    if (key == 1000) {
+    // Handle mouse button
+    if (key == Engine::Key::MOUSE_LEFT) {
         m_shooting = pressed;
     }
 }
@@ -210,53 +542,92 @@ void Game::handleShooting() {
     glm::vec3 origin = m_player.getCamera().getPosition();
     glm::vec3 direction = m_player.getCamera().getFront();
     
-    // Check enemy hits (simple distance check for now)
-    for (auto& enemy : m_enemies) {
-        if (!enemy->isAlive()) continue;
-        
-        glm::vec3 toEnemy = enemy->getPosition() - origin;
-        float distance = glm::length(toEnemy);
-        
-        if (distance < 50.0f) {
-            glm::vec3 toEnemyDir = glm::normalize(toEnemy);
-            float dot = glm::dot(direction, toEnemyDir);
-            
-            // Check if aiming at enemy (within a cone)
-            if (dot > 0.98f) {
-                enemy->takeDamage(25.0f);
-                
-                // Hit particles
-                m_particles.emit(enemy->getPosition(), -direction,
-                               glm::vec3(1.0f, 0.0f, 0.0f), 5);
-                
-                if (!enemy->isAlive()) {
-                    std::cout << "Enemy killed!" << std::endl;
-                }
-            }
-        }
+    ShotHit hit = traceShot(origin, direction, 50.0f);
+    
+    if (hit.target == ShotHit::Target::WALL) {
+        // Impact dust, so shots into cover still read as hits
+        m_particles.emit(hit.point, hit.normal, m_level.getWalls()[hit.index].color, 3);
+        return;
+    }
+    
+    if (hit.target != ShotHit::Target::ENEMY) return;
+    
+    m_enemies.takeDamage(hit.index, 25.0f);
+    
+    // Hit particles
+    m_particles.emit(hit.point, hit.normal, glm::vec3(1.0f, 0.0f, 0.0f), 5);
+    
+    if (!m_enemies.isAlive(hit.index)) {
+        std::cout << "Enemy killed!" << std::endl;
     }
 }
 
-void Game::checkCollisions() {
-    // Simple enemy damage
-    glm::vec3 playerPos = m_player.getPosition();
+ShotHit Game::traceShot(const glm::vec3& origin, const glm::vec3& direction, float range) {
+    ShotHit result;
+    Engine::RayHit hit;
     
-    for (auto& enemy : m_enemies) {
-        if (!enemy->isAlive()) continue;
+    // Walls first: the nearest wall hit caps how far enemies can be hit
+    if (m_level.getWallBVH().raycast(origin, direction, range, hit)) {
+        result.target = ShotHit::Target::WALL;
+        result.index = hit.index;
+        result.distance = hit.distance;
+        result.point = hit.point;
+        result.normal = hit.normal;
+        range = hit.distance;
+    }
+    
+    // Enemies near the ray come from the grid, then get an exact box test
+    m_queryResults.clear();
+    m_enemies.getSpatialHash().queryRay(origin, direction, range,
+                                        EnemyStore::kHitRadius, m_queryResults);
+    
+    m_shotBoxes.clear();
+    m_shotTargets.clear();
+    for (uint32_t i : m_queryResults) {
+        if (!m_enemies.isAlive(i)) continue;
         
-        float distance = glm::length(enemy->getPosition() - playerPos);
-        if (distance < 2.0f) {
-            m_player.takeDamage(5.0f * m_window.getDeltaTime());
+        glm::vec3 position = m_enemies.getPosition(i);
+        m_shotBoxes.add(position - glm::vec3(0.5f), position + glm::vec3(0.5f));
+        m_shotTargets.push_back(i);
+    }
+    
+    if (Engine::raycastBoxes(m_shotBoxes, origin, direction, range, hit)) {
+        result.target = ShotHit::Target::ENEMY;
+        result.index = m_shotTargets[hit.index];
+        result.distance = hit.distance;
+        result.point = hit.point;
+        result.normal = hit.normal;
+    }
+    
+    return result;
+}
+
+void Game::checkCollisions(float deltaTime) {
+    // Simple enemy damage: count enemies in contact, then apply it once
+    m_queryResults.clear();
+    m_enemies.getSpatialHash().queryRadius(m_player.getPosition(), 2.0f, m_queryResults);
+    
+    int touching = 0;
+    for (uint32_t i : m_queryResults) {
+        if (m_enemies.isAlive(i)) {
+            ++touching;
         }
     }
+    
+    if (touching > 0) {
+        m_player.takeDamage(5.0f * deltaTime * touching);
+    }
 }
 
 void Game::spawnEnemies() {
-    int enemyCount = 3 + m_wave;
+    int enemyCount = m_config.waveSize > 0 ? m_config.waveSize : 3 + m_wave;
+    m_enemies.reserve(m_enemies.size() + enemyCount);
     
     for (int i = 0; i < enemyCount; ++i) {
         float angle = (float)i / enemyCount * 2.0f * M_PI;
-        float radius = 10.0f + (m_wave * 2.0f);
+        // Just inside the arena walls (inner face at 9.5); shots don't go
+        // through walls, so enemies spawned outside could never be hit
+        float radius = 8.5f;
         
         glm::vec3 pos(
             cos(angle) * radius,
@@ -264,16 +635,21 @@ void Game::spawnEnemies() {
             sin(angle) * radius
         );
         
-        m_enemies.push_back(std::make_unique<Enemy>(pos));
+        m_enemies.spawn(pos);
     }
     
     std::cout << "Spawned " << enemyCount << " enemies!" << std::endl;
 }
 
 void Game::shutdown() {
+    m_recorder.close();
     m_enemies.clear();
     m_weapon.reset();
+#ifndef FPS_HEADLESS
+    m_renderer.shutdown();
+    m_assets.close();
     m_window.shutdown();
+#endif
 }
 
 } // namespace Game
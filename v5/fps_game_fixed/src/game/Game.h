@@ -1,49 +1,176 @@
 #ifndef GAME_H
 #define GAME_H
 
+#ifndef FPS_HEADLESS
 #include "../engine/Window.h"
 #include "../engine/Renderer.h"
+#include "../engine/OcclusionCuller.h"
+#include "../engine/MeshLod.h"
+#include "../engine/AssetPack.h"
+#endif
 #include "Player.h"
 #include "Weapon.h"
 #include "Enemy.h"
 #include "Level.h"
 #include "Particle.h"
+#include "RenderSnapshot.h"
+#include "../engine/InputRecording.h"
+#include "../engine/JobSystem.h"
+#include "../engine/Raycast.h"
+#include "../engine/CharacterController.h"
+#include <string>
 #include <vector>
 #include <memory>
+#ifndef FPS_HEADLESS
+#include <condition_variable>
+#include <mutex>
+#endif
 
 namespace Game {
 
+struct GameConfig {
+    // Simulation rate in Hz. 0 keeps the old variable-timestep loop.
+    float fixedTimestepHz = 0.0f;
+    // Upper bound on fixed steps per rendered frame, so a slow frame
+    // can't snowball into ever more simulation work.
+    int maxStepsPerFrame = 5;
+    // Headless builds only: a match ends on player death or after this
+    // much simulated time.
+    float maxMatchSeconds = 600.0f;
+    
+    // Seed for all gameplay randomness; 0 picks one from the clock
+    uint32_t seed = 0;
+    // Write every frame's input to this file
+    std::string recordPath;
+    // Play input back from this file instead of the keyboard and mouse
+    std::string replayPath;
+    
+    // Simulate frame N+1 on a worker thread while frame N is rendered
+    bool pipelined = false;
+    
+    // Print render queue batching counters every 300 frames
+    bool renderStats = false;
+    
+    // Skip draws hidden behind walls using a CPU depth buffer
+    bool occlusionCulling = true;
+    
+    // Compiled shader programs are kept here between launches; empty
+    // compiles from source every time
+    std::string shaderCacheDir = "shader_cache";
+    
+    // Bytes of streamed texture mips uploaded per frame, in KB
+    int textureUploadBudgetKB = 2048;
+    // Memory-mapped asset pack searched before loose files; empty reads
+    // everything from disk
+    std::string assetPack;
+    
+    // Job system workers for the per-entity loops: -1 uses every core,
+    // any other value pins the count (0 runs everything on one thread)
+    int workerThreads = -1;
+    
+    // Enemies per wave; 0 keeps the normal 3 + wave ramp
+    int waveSize = 0;
+    
+    // Hard cap on live particles; when full the ones closest to expiring are reused
+    int maxParticles = 4096;
+};
+
+// First thing a hitscan shot struck
+struct ShotHit {
+    enum class Target { NONE, ENEMY, WALL };
+    
+    Target target = Target::NONE;
+    // Enemy index or wall index, depending on target
+    size_t index = 0;
+    float distance = 0.0f;
+    glm::vec3 point = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+};
+
 class Game {
 public:
-    Game();
+    explicit Game(const GameConfig& config = GameConfig());
     ~Game();
 
     bool init();
     void run();
     void shutdown();
 
+    bool isGameOver() const { return m_gameOver; }
+    int getScore() const { return m_score; }
+    int getWave() const { return m_wave; }
+    float getSimulatedTime() const { return m_simulatedTime; }
+
 private:
     void processInput();
+    bool pumpInput(float& deltaTime);
+    float advance(float deltaTime);
     void update(float deltaTime);
-    void render();
+#ifndef FPS_HEADLESS
+    void runSerial();
+    void runPipelined();
+    void simulationThread();
+    void captureSnapshot(float alpha, RenderSnapshot& snapshot);
+    void render(RenderSnapshot& snapshot);
+#else
+    void driveBot();
+#endif
     
     void handleKeyInput(int key, bool pressed);
     void handleMouseMove(double xoffset, double yoffset);
     void handleShooting();
-    void checkCollisions();
+    ShotHit traceShot(const glm::vec3& origin, const glm::vec3& direction, float range);
+    void checkCollisions(float deltaTime);
     void spawnEnemies();
 
+#ifndef FPS_HEADLESS
     Engine::Window m_window;
+    Engine::AssetPack m_assets; // outlives the renderer's texture decoders
     Engine::Renderer m_renderer;
+    // Enemies are spheres; EnemyStore keeps each one's LOD level
+    Engine::LodChain m_enemyLods;
+    Engine::RenderQueue m_renderQueue;
+    Engine::OcclusionCuller m_occlusion;
+    int m_renderStatsFrame;
+    
+    // Double-buffered snapshots: the renderer reads the front one while
+    // the simulation thread fills the back one
+    RenderSnapshot m_snapshots[2];
+    int m_frontSnapshot;
+    
+    // Hand-off between the main thread and the simulation thread
+    std::mutex m_simMutex;
+    std::condition_variable m_simCondition;
+    float m_simDeltaTime;
+    bool m_simBusy;
+    bool m_simStopped;
+    bool m_simQuit;
+#endif
     
     Player m_player;
     std::unique_ptr<Weapon> m_weapon;
-    std::vector<std::unique_ptr<Enemy>> m_enemies;
+    EnemyStore m_enemies;
+    std::vector<uint32_t> m_queryResults;
+    Engine::AABBBatch m_shotBoxes;
+    std::vector<uint32_t> m_shotTargets;
     Level m_level;
+    Engine::CharacterController m_controller; // collides against m_level
     ParticleSystem m_particles;
     
+    GameConfig m_config;
+    Engine::JobSystem m_jobs;
+    float m_accumulator;
+    
+    std::vector<Engine::InputEvent> m_pendingInput; // filled by window callbacks
+    std::vector<Engine::InputEvent> m_frameInput;   // consumed by the simulation
+    Engine::InputRecorder m_recorder;
+    Engine::InputPlayback m_playback;
+    bool m_replaying;
+
     bool m_initialized;
     bool m_shooting;
+    bool m_gameOver;
+    float m_simulatedTime;
     
     float m_enemySpawnTimer;
     int m_score;
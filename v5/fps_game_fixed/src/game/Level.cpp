@@ -1,13 +1,11 @@
 #include "Level.h"
-#include "../engine/Renderer.h"
-#include <glm/gtc/matrix_transform.hpp>
+#ifndef FPS_HEADLESS
+#include "../engine/RenderQueue.h"
+#endif
 
 namespace Game {
 
-Level::Level()
-    : m_wallMesh(Engine::Mesh::createCube(glm::vec3(0.7f, 0.7f, 0.7f)))
-    , m_floorMesh(Engine::Mesh::createPlane(100.0f, glm::vec3(0.3f, 0.5f, 0.3f)))
-{
+Level::Level() {
 }
 
 Level::~Level() {
@@ -81,20 +79,50 @@ void Level::generate() {
         glm::vec3(4.0f, 1.0f, 4.0f),
         glm::vec3(0.4f, 0.4f, 0.6f)
     });
+    
+    // Walls are unit cubes scaled around their centre
+    std::vector<Engine::AABB> bounds;
+    bounds.reserve(m_walls.size());
+    for (const auto& wall : m_walls) {
+        glm::vec3 half = wall.scale * 0.5f;
+        bounds.push_back({wall.position - half, wall.position + half});
+    }
+    m_wallBVH.build(bounds);
 }
 
-void Level::render(Engine::Renderer& renderer) {
-    // Render floor
-    glm::mat4 floorModel = glm::mat4(1.0f);
-    renderer.renderMesh(m_floorMesh, floorModel, glm::vec3(0.3f, 0.5f, 0.3f));
+#ifndef FPS_HEADLESS
+void Level::loadMeshes(Engine::MeshCache& meshes) {
+    std::vector<Engine::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<Engine::Vertex> shapeVertices;
+    std::vector<unsigned int> shapeIndices;
+    
+    // Floor
+    glm::vec3 floorColor(0.3f, 0.5f, 0.3f);
+    Engine::Mesh::buildPlane(100.0f, floorColor, shapeVertices, shapeIndices);
+    Engine::Mesh::appendTransformed(vertices, indices, shapeVertices, shapeIndices,
+                                    glm::vec3(0.0f), glm::vec3(1.0f), floorColor);
     
-    // Render walls
+    // Walls
+    Engine::Mesh::buildCube(glm::vec3(0.7f, 0.7f, 0.7f), shapeVertices, shapeIndices);
+    vertices.reserve(vertices.size() + m_walls.size() * shapeVertices.size());
+    indices.reserve(indices.size() + m_walls.size() * shapeIndices.size());
     for (const auto& wall : m_walls) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, wall.position);
-        model = glm::scale(model, wall.scale);
-        renderer.renderMesh(m_wallMesh, model, wall.color);
+        Engine::Mesh::appendTransformed(vertices, indices, shapeVertices, shapeIndices,
+                                        wall.position, wall.scale, wall.color);
     }
+    
+    Engine::Mesh mesh;
+    mesh.setupMesh(vertices, indices);
+    m_staticMesh = meshes.adopt(std::move(mesh));
+}
+
+void Level::render(Engine::RenderQueue& queue) {
+    if (!m_staticMesh) return;
+    
+    RenderInstance identity = { glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.0f) };
+    queue.submit(Engine::RenderPass::OPAQUE, *m_staticMesh, identity);
 }
+#endif // FPS_HEADLESS
 
 } // namespace Game
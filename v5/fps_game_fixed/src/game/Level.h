@@ -1,12 +1,16 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
-#include "../engine/Mesh.h"
+#ifndef FPS_HEADLESS
+#include "../engine/MeshCache.h"
+#endif
+#include "RenderSnapshot.h"
+#include "../engine/BVH.h"
 #include <glm/glm.hpp>
 #include <vector>
 
-// Forward declare Renderer so we avoid a circular include
-namespace Engine { class Renderer; }
+// Forward declare RenderQueue so we avoid a circular include
+namespace Engine { class RenderQueue; }
 
 namespace Game {
 
@@ -22,14 +26,23 @@ public:
     ~Level();
 
     void generate();
-    void render(Engine::Renderer& renderer);
+#ifndef FPS_HEADLESS
+    void loadMeshes(Engine::MeshCache& meshes);
+    // Walls never move after generate(), so the whole level is drawn
+    // from one pre-transformed mesh
+    void render(Engine::RenderQueue& queue);
+#endif
     
     const std::vector<Wall>& getWalls() const { return m_walls; }
+    // Wall boxes indexed for ray/overlap queries; box i is getWalls()[i]
+    const Engine::BVH& getWallBVH() const { return m_wallBVH; }
 
 private:
     std::vector<Wall> m_walls;
-    Engine::Mesh m_wallMesh;
-    Engine::Mesh m_floorMesh;
+    Engine::BVH m_wallBVH;
+#ifndef FPS_HEADLESS
+    Engine::MeshHandle m_staticMesh; // floor + every wall, baked by loadMeshes
+#endif
 };
 
 } // namespace Game
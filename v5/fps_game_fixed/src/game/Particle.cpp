@@ -1,71 +1,146 @@
 #include "Particle.h"
-#include "../engine/Renderer.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <cstdlib>
-#include <ctime>
+#include "../engine/JobSystem.h"
+#include "../engine/SimdKernels.h"
+#ifndef FPS_HEADLESS
+#include "../engine/RenderQueue.h"
+#endif
+#include <algorithm>
 
 namespace Game {
 
-ParticleSystem::ParticleSystem()
-    : m_particleMesh(Engine::Mesh::createCube(glm::vec3(1.0f)))
+ParticleSystem::ParticleSystem(size_t capacity)
+    : m_count(0)
+    , m_overflow(ParticleOverflow::RECYCLE_OLDEST)
 {
-    srand(time(nullptr));
+    setCapacity(capacity);
 }
 
 ParticleSystem::~ParticleSystem() {
 }
 
-void ParticleSystem::update(float deltaTime) {
-    for (auto it = m_particles.begin(); it != m_particles.end();) {
-        it->life -= deltaTime;
+void ParticleSystem::setCapacity(size_t capacity) {
+    m_positions.assign(capacity, glm::vec3(0.0f));
+    m_prevPositions.assign(capacity, glm::vec3(0.0f));
+    m_velocities.assign(capacity, glm::vec3(0.0f));
+    m_colors.assign(capacity, glm::vec3(0.0f));
+    m_life.assign(capacity, 0.0f);
+    m_sizes.assign(capacity, 0.0f);
+    m_slots.reserve(capacity);
+    m_count = 0;
+}
+
+void ParticleSystem::moveParticle(size_t from, size_t to) {
+    m_positions[to] = m_positions[from];
+    m_prevPositions[to] = m_prevPositions[from];
+    m_velocities[to] = m_velocities[from];
+    m_colors[to] = m_colors[from];
+    m_life[to] = m_life[from];
+    m_sizes[to] = m_sizes[from];
+}
+
+void ParticleSystem::update(float deltaTime, Engine::JobSystem& jobs) {
+    // Integrate in parallel with the SIMD kernels, then swap-remove the
+    // expired particles. Expired ones are integrated too; they are gone
+    // before anyone reads them.
+    const Engine::SimdKernels& simd = Engine::SimdKernels::get();
+    const glm::vec3 gravity(0.0f, -9.8f, 0.0f);
+    jobs.parallelFor(m_count, 1024, [&](size_t begin, size_t end) {
+        size_t n = end - begin;
+        simd.add(&m_life[begin], n, -deltaTime);
         
-        if (it->life <= 0.0f) {
-            it = m_particles.erase(it);
+        // Update physics
+        std::copy(m_positions.begin() + begin, m_positions.begin() + end, m_prevPositions.begin() + begin);
+        simd.integrate(&m_positions[begin], &m_velocities[begin], n, gravity, deltaTime);
+        
+        // Fade out
+        simd.scale(&m_colors[begin].x, n * 3, 0.98f);
+        simd.scale(&m_sizes[begin], n, 0.98f);
+    });
+    
+    size_t i = 0;
+    while (i < m_count) {
+        if (m_life[i] <= 0.0f) {
+            moveParticle(--m_count, i);
         } else {
-            // Update physics
-            it->velocity.y -= 9.8f * deltaTime; // Gravity
-            it->position += it->velocity * deltaTime;
-            
-            // Fade out
-            it->color *= 0.98f;
-            it->size *= 0.98f;
-            
-            ++it;
+            ++i;
         }
     }
 }
 
+size_t ParticleSystem::allocate(size_t wanted, std::vector<uint32_t>& slots) {
+    slots.clear();
+    
+    // Only particles that were live before this call may be recycled; the
+    // slots just handed out still hold stale life values
+    size_t live = m_count;
+    size_t capacity = getCapacity();
+    while (slots.size() < wanted && m_count < capacity) {
+        slots.push_back(static_cast<uint32_t>(m_count++));
+    }
+    
+    size_t missing = wanted - slots.size();
+    if (missing == 0 || m_overflow == ParticleOverflow::DROP_NEW || live == 0) {
+        return slots.size();
+    }
+    
+    // Pool is full: take over the live particles with the least life left
+    missing = std::min(missing, live);
+    size_t first = slots.size();
+    for (size_t i = 0; i < live; ++i) {
+        slots.push_back(static_cast<uint32_t>(i));
+    }
+    std::nth_element(slots.begin() + first, slots.begin() + first + missing - 1, slots.end(),
+        [this](uint32_t a, uint32_t b) { return m_life[a] < m_life[b]; });
+    slots.resize(first + missing);
+    return slots.size();
+}
+
 void ParticleSystem::emit(const glm::vec3& position, const glm::vec3& direction, 
                           const glm::vec3& color, int count) {
-    for (int i = 0; i < count; ++i) {
-        Particle particle;
-        particle.position = position;
+    if (count <= 0) return;
+    
+    size_t slotCount = allocate(static_cast<size_t>(count), m_slots);
+    for (size_t n = 0; n < slotCount; ++n) {
+        size_t i = m_slots[n];
+        m_positions[i] = position;
+        m_prevPositions[i] = position;
         
         // Random spread
         float spread = 0.5f;
-        particle.velocity = direction + glm::vec3(
-            (rand() % 100 - 50) / 50.0f * spread,
-            (rand() % 100 - 50) / 50.0f * spread,
-            (rand() % 100 - 50) / 50.0f * spread
+        glm::vec3 velocity = direction + glm::vec3(
+            (randomInt(100) - 50) / 50.0f * spread,
+            (randomInt(100) - 50) / 50.0f * spread,
+            (randomInt(100) - 50) / 50.0f * spread
         );
-        particle.velocity *= 2.0f + (rand() % 100) / 100.0f;
+        m_velocities[i] = velocity * (2.0f + randomInt(100) / 100.0f);
         
-        particle.color = color;
-        particle.life = 0.5f + (rand() % 100) / 200.0f;
-        particle.size = 0.05f + (rand() % 50) / 500.0f;
-        
-        m_particles.push_back(particle);
+        m_colors[i] = color;
+        m_life[i] = 0.5f + randomInt(100) / 200.0f;
+        m_sizes[i] = 0.05f + randomInt(50) / 500.0f;
     }
 }
 
-void ParticleSystem::render(Engine::Renderer& renderer) {
-    for (const auto& particle : m_particles) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, particle.position);
-        model = glm::scale(model, glm::vec3(particle.size));
-        
-        renderer.renderMesh(m_particleMesh, model, particle.color);
+void ParticleSystem::snapshot(float alpha, std::vector<RenderInstance>& instances) const {
+    instances.clear();
+    for (size_t i = 0; i < m_count; ++i) {
+        instances.push_back({
+            glm::mix(m_prevPositions[i], m_positions[i], alpha),
+            glm::vec3(m_sizes[i]),
+            m_colors[i]
+        });
     }
 }
 
+#ifndef FPS_HEADLESS
+void ParticleSystem::loadMeshes(Engine::MeshCache& meshes) {
+    m_particleMesh = meshes.getCube(glm::vec3(1.0f));
+}
+
+void ParticleSystem::render(Engine::RenderQueue& queue, const std::vector<RenderInstance>& instances) {
+    if (!m_particleMesh) return;
+    
+    queue.submitCulled(Engine::RenderPass::OPAQUE, *m_particleMesh, instances.data(), instances.size());
+}
+#endif // FPS_HEADLESS
+
 } // namespace Game
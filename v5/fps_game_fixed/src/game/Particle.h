@@ -1,37 +1,75 @@
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
-#include "../engine/Mesh.h"
+#ifndef FPS_HEADLESS
+#include "../engine/MeshCache.h"
+#endif
+#include "RenderSnapshot.h"
 #include <glm/glm.hpp>
+#include <cstddef>
 #include <vector>
+#include <random>
+#include <cstdint>
 
 // Forward declare Renderer to avoid circular include
-namespace Engine { class Renderer; }
+namespace Engine { class RenderQueue; class JobSystem; }
 
 namespace Game {
 
-struct Particle {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 color;
-    float life;
-    float size;
+// What emit() does once the pool is full
+enum class ParticleOverflow {
+    DROP_NEW,       // ignore the new particles
+    RECYCLE_OLDEST  // reuse the slots of the particles closest to expiring
 };
 
+// Fixed-capacity particle pool. Each attribute lives in its own array,
+// allocated once; expired particles are removed by moving the last live
+// particle into their slot, so nothing is ever shifted or reallocated.
 class ParticleSystem {
 public:
-    ParticleSystem();
+    static const size_t kDefaultCapacity = 4096;
+
+    explicit ParticleSystem(size_t capacity = kDefaultCapacity);
     ~ParticleSystem();
 
-    void update(float deltaTime);
+    // Drops all live particles
+    void setCapacity(size_t capacity);
+    void setOverflow(ParticleOverflow overflow) { m_overflow = overflow; }
+
+    void seed(uint32_t seed) { m_rng.seed(seed); }
+    void update(float deltaTime, Engine::JobSystem& jobs);
     void emit(const glm::vec3& position, const glm::vec3& direction, 
               const glm::vec3& color, int count = 10);
+    void clear() { m_count = 0; }
+    
+    size_t size() const { return m_count; }
+    size_t getCapacity() const { return m_life.size(); }
     
-    void render(Engine::Renderer& renderer);
+    void snapshot(float alpha, std::vector<RenderInstance>& instances) const;
+#ifndef FPS_HEADLESS
+    void loadMeshes(Engine::MeshCache& meshes);
+    void render(Engine::RenderQueue& queue, const std::vector<RenderInstance>& instances);
+#endif
 
 private:
-    std::vector<Particle> m_particles;
-    Engine::Mesh m_particleMesh;
+    int randomInt(int range) { return static_cast<int>(m_rng() % range); }
+    size_t allocate(size_t wanted, std::vector<uint32_t>& slots);
+    void moveParticle(size_t from, size_t to);
+
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::vec3> m_prevPositions;
+    std::vector<glm::vec3> m_velocities;
+    std::vector<glm::vec3> m_colors;
+    std::vector<float> m_life;
+    std::vector<float> m_sizes;
+    size_t m_count;
+    
+    ParticleOverflow m_overflow;
+    std::vector<uint32_t> m_slots; // scratch for emit()
+    std::mt19937 m_rng;
+#ifndef FPS_HEADLESS
+    Engine::MeshHandle m_particleMesh;
+#endif
 };
 
 } // namespace Game
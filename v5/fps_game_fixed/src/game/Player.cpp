@@ -1,5 +1,5 @@
 #include "Player.h"
-#include <SDL2/SDL.h>
+#include "../engine/Keys.h"
 #include <algorithm>
 
 namespace Game {
@@ -7,6 +7,7 @@ namespace Game {
 Player::Player()
     : m_camera(glm::vec3(0.0f, 1.8f, 5.0f))
     , m_position(0.0f, 1.8f, 5.0f)
+    , m_prevPosition(0.0f, 1.8f, 5.0f)
     , m_velocity(0.0f)
     , m_health(100.0f)
     , m_maxHealth(100.0f)
@@ -15,19 +16,33 @@ Player::Player()
     , m_isGrounded(true)
 {
     for (int i = 0; i < 6; ++i) m_keys[i] = false;
+    
+    m_shape.radius = 0.4f;
+    m_shape.height = 1.9f;
+    m_shape.stepHeight = 0.4f;
 }
 
 Player::~Player() {
 }
 
-void Player::update(float deltaTime) {
-    // Process movement
+void Player::update(float deltaTime, const Engine::CharacterController& controller) {
+    m_prevPosition = m_position;
+    
+    // Walk on the ground plane whatever the camera pitch
+    glm::vec3 forward = m_camera.getFront();
+    glm::vec3 right = m_camera.getRight();
+    forward.y = 0.0f;
+    right.y = 0.0f;
+    
     glm::vec3 movement(0.0f);
+    if (m_keys[0]) movement += forward; // W
+    if (m_keys[1]) movement -= right;   // A
+    if (m_keys[2]) movement -= forward; // S
+    if (m_keys[3]) movement += right;   // D
     
-    if (m_keys[0]) m_camera.processKeyboard(Engine::FORWARD, deltaTime); // W
-    if (m_keys[1]) m_camera.processKeyboard(Engine::LEFT, deltaTime);    // A
-    if (m_keys[2]) m_camera.processKeyboard(Engine::BACKWARD, deltaTime);// S
-    if (m_keys[3]) m_camera.processKeyboard(Engine::RIGHT, deltaTime);   // D
+    if (glm::length(movement) > 1e-4f) {
+        movement = glm::normalize(movement) * m_speed;
+    }
     
     // Jumping
     if (m_keys[4] && m_isGrounded) { // Space
@@ -41,19 +56,17 @@ void Player::update(float deltaTime) {
     }
     
     // Apply gravity
-    if (!m_isGrounded) {
-        m_velocity.y -= 20.0f * deltaTime;
-    }
+    m_velocity.y -= 20.0f * deltaTime;
     
-    // Update position
-    m_position = m_camera.getPosition();
-    m_position += m_velocity * deltaTime;
+    // Move the capsule through the level
+    glm::vec3 displacement(movement.x * deltaTime, m_velocity.y * deltaTime, movement.z * deltaTime);
+    glm::vec3 feet = m_position - glm::vec3(0.0f, kEyeHeight, 0.0f);
+    Engine::MoveResult result = controller.move(feet, displacement, m_shape);
     
-    // Ground check (simple)
-    if (m_position.y <= 1.8f) {
-        m_position.y = 1.8f;
+    m_position = result.position + glm::vec3(0.0f, kEyeHeight, 0.0f);
+    m_isGrounded = result.grounded;
+    if ((result.grounded && m_velocity.y < 0.0f) || (result.hitCeiling && m_velocity.y > 0.0f)) {
         m_velocity.y = 0.0f;
-        m_isGrounded = true;
     }
     
     m_camera.setPosition(m_position);
@@ -61,12 +74,12 @@ void Player::update(float deltaTime) {
 
 void Player::processInput(int key, bool pressed) {
     switch (key) {
-        case SDL_SCANCODE_W: m_keys[0] = pressed; break;
-        case SDL_SCANCODE_A: m_keys[1] = pressed; break;
-        case SDL_SCANCODE_S: m_keys[2] = pressed; break;
-        case SDL_SCANCODE_D: m_keys[3] = pressed; break;
-        case SDL_SCANCODE_SPACE: m_keys[4] = pressed; break;
-        case SDL_SCANCODE_LSHIFT: m_keys[5] = pressed; break;
+        case Engine::Key::W: m_keys[0] = pressed; break;
+        case Engine::Key::A: m_keys[1] = pressed; break;
+        case Engine::Key::S: m_keys[2] = pressed; break;
+        case Engine::Key::D: m_keys[3] = pressed; break;
+        case Engine::Key::SPACE: m_keys[4] = pressed; break;
+        case Engine::Key::LSHIFT: m_keys[5] = pressed; break;
     }
 }
 
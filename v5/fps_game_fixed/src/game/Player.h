@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include "../engine/Camera.h"
+#include "../engine/CharacterController.h"
 #include <glm/glm.hpp>
 
 namespace Game {
@@ -11,12 +12,13 @@ public:
     Player();
     ~Player();
 
-    void update(float deltaTime);
+    void update(float deltaTime, const Engine::CharacterController& controller);
     void processInput(int key, bool pressed);
     void processMouseMove(float xoffset, float yoffset);
 
     Engine::Camera& getCamera() { return m_camera; }
     glm::vec3 getPosition() const { return m_position; }
+    glm::vec3 getInterpolatedPosition(float alpha) const { return glm::mix(m_prevPosition, m_position, alpha); }
     float getHealth() const { return m_health; }
     
     void takeDamage(float damage);
@@ -27,6 +29,7 @@ public:
 private:
     Engine::Camera m_camera;
     glm::vec3 m_position;
+    glm::vec3 m_prevPosition;
     glm::vec3 m_velocity;
     
     float m_health;
@@ -36,6 +39,9 @@ private:
     
     bool m_keys[6]; // W, A, S, D, Space, Shift
     bool m_isGrounded;
+    
+    Engine::CharacterShape m_shape;
+    static constexpr float kEyeHeight = 1.8f;
 };
 
 } // namespace Game
@@ -0,0 +1,28 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include "../engine/Camera.h"
+#include "../engine/MeshInstance.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Game {
+
+// One unrotated, scaled box-shaped draw
+typedef Engine::MeshInstance RenderInstance;
+
+// Everything render() needs for one frame, copied out of the simulation
+// (with interpolation already applied) so the simulation can move on to
+// the next frame while this one is being drawn.
+struct RenderSnapshot {
+    Engine::Camera camera;
+    std::vector<RenderInstance> enemies;
+    std::vector<uint8_t> enemyLodLevels; // mesh LOD level per enemy
+    std::vector<RenderInstance> particles;
+    bool hasWeapon = false;
+};
+
+} // namespace Game
+
+#endif // RENDER_SNAPSHOT_H
@@ -20,9 +20,6 @@ Weapon::Weapon(WeaponType type)
     , m_barrelPos(0.0f)
     , m_direction(0.0f, 0.0f, -1.0f)
 {
-    // Create weapon mesh (simple box for now)
-    m_mesh = Engine::Mesh::createCube(glm::vec3(0.3f, 0.3f, 0.3f));
-    
     // Customize based on type
     switch (m_type) {
         case WeaponType::PISTOL:
@@ -57,6 +54,13 @@ Weapon::Weapon(WeaponType type)
 Weapon::~Weapon() {
 }
 
+#ifndef FPS_HEADLESS
+void Weapon::loadMeshes(Engine::MeshCache& meshes) {
+    // Simple box for now
+    m_mesh = meshes.getCube(glm::vec3(0.3f, 0.3f, 0.3f));
+}
+#endif
+
 void Weapon::update(float deltaTime) {
     m_timeSinceLastShot += deltaTime;
     
@@ -1,7 +1,9 @@
 #ifndef WEAPON_H
 #define WEAPON_H
 
-#include "../engine/Mesh.h"
+#ifndef FPS_HEADLESS
+#include "../engine/MeshCache.h"
+#endif
 #include <glm/glm.hpp>
 #include <string>
 
@@ -30,12 +32,17 @@ public:
     glm::vec3 getBarrelPosition() const { return m_barrelPos; }
     glm::vec3 getDirection() const { return m_direction; }
     
-    Engine::Mesh& getMesh() { return m_mesh; }
+#ifndef FPS_HEADLESS
+    void loadMeshes(Engine::MeshCache& meshes);
+    const Engine::MeshHandle& getMesh() const { return m_mesh; }
+#endif
     glm::mat4 getModelMatrix() const;
 
 private:
     WeaponType m_type;
-    Engine::Mesh m_mesh;
+#ifndef FPS_HEADLESS
+    Engine::MeshHandle m_mesh;
+#endif
     
     int m_currentAmmo;
     int m_maxAmmo;
@@ -1,10 +1,48 @@
 #include "game/Game.h"
 #include <iostream>
 #include <exception>
+#include <cstdlib>
+#include <cstring>
 
-int main(int /*argc*/, char* /*argv*/[]) {
+int main(int argc, char* argv[]) {
+    Game::GameConfig config;
+    
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--fixed-hz") == 0 && i + 1 < argc) {
+            config.fixedTimestepHz = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--pipelined") == 0) {
+            config.pipelined = true;
+        } else if (std::strcmp(argv[i], "--render-stats") == 0) {
+            config.renderStats = true;
+        } else if (std::strcmp(argv[i], "--no-occlusion") == 0) {
+            config.occlusionCulling = false;
+        } else if (std::strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc) {
+            config.shaderCacheDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-shader-cache") == 0) {
+            config.shaderCacheDir.clear();
+        } else if (std::strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc) {
+            config.textureUploadBudgetKB = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--asset-pack") == 0 && i + 1 < argc) {
+            config.assetPack = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            config.workerThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--wave-size") == 0 && i + 1 < argc) {
+            config.waveSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-particles") == 0 && i + 1 < argc) {
+            config.maxParticles = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            config.recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            config.replayPath = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+        }
+    }
+    
     try {
-        Game::Game game;
+        Game::Game game(config);
         
         if (!game.init()) {
             std::cerr << "Failed to initialize game!" << std::endl;
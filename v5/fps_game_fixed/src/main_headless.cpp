@@ -0,0 +1,88 @@
+#include "game/Game.h"
+#include <iostream>
+#include <exception>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// Runs whole matches with no window or GL context, driven by the built-in
+// aim bot or by a recording from FPSGame --record. Used for balancing runs
+// and regression timing on CPU-only hosts.
+int main(int argc, char* argv[]) {
+    Game::GameConfig config;
+    config.fixedTimestepHz = 60.0f;
+    int matches = 1;
+    bool verbose = false;
+    
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fixed-hz") == 0 && i + 1 < argc) {
+            config.fixedTimestepHz = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) {
+            config.maxMatchSeconds = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            config.workerThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--wave-size") == 0 && i + 1 < argc) {
+            config.waveSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-particles") == 0 && i + 1 < argc) {
+            config.maxParticles = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            config.replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+        }
+    }
+    
+    // Game code logs every shot; keep that off the hot path unless asked
+    std::streambuf* coutBuffer = std::cout.rdbuf();
+    std::ostream report(coutBuffer);
+    if (!verbose) {
+        std::cout.rdbuf(nullptr);
+    }
+    
+    try {
+        auto start = std::chrono::steady_clock::now();
+        double totalSimulated = 0.0;
+        
+        for (int match = 0; match < matches; ++match) {
+            Game::Game game(config);
+            
+            if (!game.init()) {
+                std::cout.rdbuf(coutBuffer);
+                std::cerr << "Failed to initialize game!" << std::endl;
+                return 1;
+            }
+            
+            game.run();
+            totalSimulated += game.getSimulatedTime();
+            
+            report << "Match " << match + 1 << ": score " << game.getScore()
+                      << ", wave " << game.getWave()
+                      << ", " << game.getSimulatedTime() << "s simulated"
+                      << (game.isGameOver() ? " (player died)" : " (survived)")
+                      << std::endl;
+            
+            game.shutdown();
+        }
+        
+        double wall = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        report << matches << " matches, " << totalSimulated << "s simulated in "
+                  << wall << "s wall (" << (wall > 0.0 ? matches * 3600.0 / wall : 0.0)
+                  << " matches/hour)" << std::endl;
+        
+        std::cout.rdbuf(coutBuffer);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cout.rdbuf(coutBuffer);
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
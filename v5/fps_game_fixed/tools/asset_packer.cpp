@@ -0,0 +1,111 @@
+#include "engine/AssetPack.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Packs loose asset files into one archive the game memory-maps at
+// startup. Entries are named by their path relative to the directory they
+// were found under, with '/' separators, which is also the name the game
+// asks for.
+//
+//   AssetPacker assets.pak [--compress] [--align N] DIR|FILE...
+//   AssetPacker --list assets.pak
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool readFile(const fs::path& path, std::vector<uint8_t>& data) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    std::streamsize size = in.tellg();
+    in.seekg(0);
+    data.resize(static_cast<size_t>(size));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(data.data()), size));
+}
+
+bool addFile(Engine::AssetPackWriter& writer, const fs::path& path, const std::string& name,
+             bool compress, uint64_t& inputBytes) {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        std::cerr << "Failed to read " << path.string() << std::endl;
+        return false;
+    }
+    inputBytes += data.size();
+    if (!writer.add(name, std::move(data), compress)) {
+        std::cerr << "Cannot pack " << path.string() << " as '" << name << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int list(const std::string& path) {
+    Engine::AssetPack pack;
+    if (!pack.open(path)) return 1;
+
+    for (size_t i = 0; i < pack.getEntryCount(); ++i) {
+        const Engine::AssetPackEntry& entry = pack.getEntry(i);
+        std::cout << pack.getEntryName(i) << "  " << entry.size << " bytes";
+        if (entry.compression != static_cast<uint8_t>(Engine::AssetCompression::NONE)) {
+            std::cout << " (" << entry.storedSize << " packed)";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << pack.getEntryCount() << " entries, " << pack.getMappedBytes() << " bytes" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::strcmp(argv[1], "--list") == 0) {
+        return list(argv[2]);
+    }
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " OUT.pak [--compress] [--align N] DIR|FILE..." << std::endl
+                  << "       " << argv[0] << " --list PACK.pak" << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    bool compress = false;
+    uint32_t alignment = 64;
+    std::vector<fs::path> inputs;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (std::strcmp(argv[i], "--align") == 0 && i + 1 < argc) {
+            alignment = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    Engine::AssetPackWriter writer(alignment);
+    uint64_t inputBytes = 0;
+    for (const fs::path& input : inputs) {
+        std::error_code error;
+        if (fs::is_regular_file(input, error)) {
+            if (!addFile(writer, input, input.filename().generic_string(), compress, inputBytes)) return 1;
+            continue;
+        }
+        if (!fs::is_directory(input, error)) {
+            std::cerr << "No such file or directory: " << input.string() << std::endl;
+            return 1;
+        }
+        for (const fs::directory_entry& file : fs::recursive_directory_iterator(input)) {
+            if (!file.is_regular_file()) continue;
+            std::string name = file.path().lexically_relative(input).generic_string();
+            if (!addFile(writer, file.path(), name, compress, inputBytes)) return 1;
+        }
+    }
+
+    if (!writer.write(output)) return 1;
+    std::cout << "Packed " << writer.getEntryCount() << " files (" << inputBytes << " bytes) into "
+              << output << " (" << fs::file_size(output) << " bytes)" << std::endl;
+    return 0;
+}